@@ -420,6 +420,21 @@ def parse_args():
         help="keep translator output file (implied by --sas-file, default: "
             "delete file if translator and search component are active)")
 
+    driver_other.add_argument(
+        "--cache-dir", metavar="DIR",
+        help="reuse the translator (and preprocessor) output of previous runs "
+            "with the same input files, options and binaries from the cache "
+            "in DIR (default: no caching)")
+    driver_other.add_argument(
+        "--cache-size-limit", metavar="SIZE", default="1G",
+        help="evict the least recently used cache entries if the cache "
+            "exceeds SIZE (in MiB, suffixes K, M, G; default: %(default)s)")
+    driver_other.add_argument(
+        "--plan-bound", metavar="VALUE", type=int,
+        help="set the plan cost bound of the translator output, i.e., "
+            "plans may cost at most VALUE. This does not change the cache "
+            "key, so runs with different bounds share the cached output.")
+
     driver_other.add_argument(
         "--portfolio", metavar="FILE",
         help="run a portfolio specified in FILE")
@@ -473,6 +488,8 @@ def parse_args():
     _set_translator_output_options(parser, args)
 
     _convert_limits_to_ints(parser, args)
+    args.cache_size_limit = _get_memory_limit_in_bytes(
+        args.cache_size_limit, parser)
 
     if args.alias:
         try:
@@ -495,5 +512,10 @@ def parse_args():
         _set_components_and_inputs(parser, args)
         if "translate" not in args.components or "search" not in args.components:
             args.keep_sas_file = True
+        if args.plan_bound is not None and (
+                "translate" not in args.components or
+                "search" not in args.components):
+            print_usage_and_exit_with_driver_input_error(
+                parser, "--plan-bound requires the translate and search components.")
 
     return args
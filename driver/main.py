@@ -33,8 +33,17 @@ def main():
         cleanup.cleanup_temporary_files(args)
         sys.exit()
 
+    cached_components = run_components.get_cached_components(args)
+    restored_from_cache = (
+        bool(cached_components) and run_components.restore_cached_task(args))
+
     exitcode = None
     for component in args.components:
+        if restored_from_cache and component in cached_components:
+            print("{} skipped: output restored from cache".format(component))
+            print()
+            exitcode = 0
+            continue
         if component == "translate":
             (exitcode, continue_execution) = run_components.run_translate(args)
         elif component == "preprocess":
@@ -48,6 +57,9 @@ def main():
             (exitcode, continue_execution) = run_components.run_validate(args)
         else:
             assert False, "Error: unhandled component: {}".format(component)
+        if (cached_components and component == cached_components[-1] and
+                exitcode == 0):
+            run_components.store_cached_task(args)
         print()
         print("{component} exit code: {exitcode}".format(**locals()))
         if not continue_execution:
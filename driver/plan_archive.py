@@ -0,0 +1,163 @@
+# -*- coding: utf-8 -*-
+
+"""
+Reader of the binary plan archives written by the search component with
+--plan-archive (see src/search/plan_archive.h for the format). Run from the
+repository root with
+
+    python3 -m driver.plan_archive ARCHIVE [--extract PREFIX | --plan N]
+
+Without options, the number, length and cost of each plan are listed.
+--extract writes the plans to the text files PREFIX.1, PREFIX.2, ... in the
+format of the planner, e.g., to validate them.
+"""
+
+from __future__ import print_function
+
+import argparse
+import sys
+import zlib
+
+MAGIC = b"FDPA"
+VERSION = 1
+
+
+class ArchiveError(Exception):
+    pass
+
+
+class _Reader(object):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def at_end(self):
+        return self.pos >= len(self.data)
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            if self.pos >= len(self.data):
+                raise EOFError()
+            byte = self.data[self.pos]
+            if not isinstance(byte, int):
+                byte = ord(byte)
+            self.pos += 1
+            value |= (byte & 0x7f) << shift
+            if byte < 0x80:
+                return value
+            shift += 7
+
+    def bytes(self, size):
+        if self.pos + size > len(self.data):
+            raise EOFError()
+        result = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return result
+
+
+class PlanArchive(object):
+    """Operators and plans of an archive. Plans are lists of operator
+    indices. A truncated last record (e.g., if the planner was killed
+    while writing it) is ignored."""
+
+    def __init__(self, filename):
+        with open(filename, "rb") as f:
+            header = f.read(len(MAGIC) + 2)
+            body = f.read()
+        if len(header) < len(MAGIC) + 2 or header[:len(MAGIC)] != MAGIC:
+            raise ArchiveError("{} is not a plan archive".format(filename))
+        version = bytearray(header[len(MAGIC):])[0]
+        compressed = bytearray(header[len(MAGIC):])[1]
+        if version != VERSION:
+            raise ArchiveError("unsupported archive version {}".format(version))
+        if compressed:
+            # The stream has no end if the planner did not terminate it.
+            body = zlib.decompressobj().decompress(body)
+        self.operator_names = []
+        self.operator_costs = []
+        self.is_unit_cost = False
+        self.plans = []
+        self._parse(_Reader(bytearray(body)))
+
+    def _parse(self, reader):
+        if reader.at_end():
+            return
+        try:
+            num_operators = reader.varint()
+            for _ in range(num_operators):
+                name = reader.bytes(reader.varint())
+                self.operator_names.append(bytes(name).decode("utf-8"))
+                self.operator_costs.append(reader.varint())
+            self.is_unit_cost = bool(reader.varint())
+        except EOFError:
+            raise ArchiveError("truncated operator table")
+        previous = []
+        while not reader.at_end():
+            try:
+                shared_prefix = reader.varint()
+                suffix = [reader.varint() for _ in range(reader.varint())]
+            except EOFError:
+                break
+            if (shared_prefix > len(previous) or
+                    any(op >= num_operators for op in suffix)):
+                raise ArchiveError("invalid record of plan {}".format(
+                    len(self.plans) + 1))
+            plan = previous[:shared_prefix] + suffix
+            self.plans.append(plan)
+            previous = plan
+
+    def cost(self, plan):
+        return sum(self.operator_costs[op] for op in plan)
+
+    def write_plan(self, plan, out):
+        for op in plan:
+            out.write("({})\n".format(self.operator_names[op]))
+        out.write("; cost = {} ({})\n".format(
+            self.cost(plan),
+            "unit cost" if self.is_unit_cost else "general cost"))
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.strip())
+    parser.add_argument("archive", help="plan archive")
+    group = parser.add_mutually_exclusive_group()
+    group.add_argument(
+        "--extract", metavar="PREFIX",
+        help="write the plans to PREFIX.1, PREFIX.2, ...")
+    group.add_argument(
+        "--plan", metavar="N", type=int,
+        help="print plan N (starting at 1)")
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    try:
+        archive = PlanArchive(args.archive)
+    except (IOError, ArchiveError) as err:
+        print("Error: {}".format(err), file=sys.stderr)
+        return 1
+
+    if args.plan is not None:
+        if not 1 <= args.plan <= len(archive.plans):
+            print("Error: the archive has {} plans".format(len(archive.plans)),
+                  file=sys.stderr)
+            return 1
+        archive.write_plan(archive.plans[args.plan - 1], sys.stdout)
+    elif args.extract:
+        for number, plan in enumerate(archive.plans, 1):
+            with open("{}.{}".format(args.extract, number), "w") as out:
+                archive.write_plan(plan, out)
+        print("Extracted {} plans".format(len(archive.plans)))
+    else:
+        for number, plan in enumerate(archive.plans, 1):
+            print("Plan {}: length {}, cost {}".format(
+                number, len(plan), archive.cost(plan)))
+        print("{} plans".format(len(archive.plans)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,196 @@
+# -*- coding: utf-8 -*-
+
+"""
+End-to-end performance regression harness. Runs a fixed corpus of local
+tasks through each engine configuration with fixed limits, writes the
+collected metrics to a JSON results file and compares them with a
+baseline. Run from the repository root with
+
+    python3 -m driver.regression --build BUILD [--results FILE]
+
+and use --write-baseline to (re)generate the baseline after intended
+changes. The baseline is only written if all runs found a plan. The exit code is 0 if no metric regressed and 1 otherwise.
+"""
+
+from __future__ import print_function
+
+import argparse
+import glob
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+from .util import DRIVER_DIR, REPO_ROOT_DIR
+
+
+TASKS_DIR = os.path.join(
+    REPO_ROOT_DIR, "src", "search", "symbolic", "benchmarks", "tasks")
+DEFAULT_BASELINE = os.path.join(DRIVER_DIR, "regression_baseline.json")
+
+# (name, domain file, problem file) relative to TASKS_DIR.
+TASKS = [
+    ("grid", "grid-domain.pddl", "grid-problem.pddl"),
+    ("robots", "robots-domain.pddl", "robots-problem.pddl"),
+]
+
+CONFIGS = [
+    ("symk-fw", "symk-fw(plan_selection=top_k(num_plans=5))"),
+    ("symk-bd", "symk-bd(plan_selection=top_k(num_plans=5))"),
+    ("symk-bd-restrict",
+     "symk-bd(plan_selection=top_k(num_plans=5),mutex_type=MUTEX_RESTRICT)"),
+    ("symq-bd", "symq-bd(plan_selection=top_k(num_plans=5),quality=1.5)"),
+    ("symosp-fw", "symosp-fw(plan_selection=top_k(num_plans=1))"),
+    ("eager_osp", "eager_osp(single(blind()))"),
+]
+
+LIMITS = ["--translate-time-limit", "5m", "--search-time-limit", "5m",
+          "--search-memory-limit", "4G"]
+
+# Patterns of the planner output. The last match is used unless the
+# metric is listed in MIN_METRICS.
+PATTERNS = [
+    ("search_time", r"^Search time: (.+)s$", float),
+    ("total_time", r"^Total time: (.+)s$", float),
+    ("expansions", r"^Expanded (\d+) state\(s\)\.$", int),
+    ("steps", r"^Symbolic steps: (\d+)$", int),
+    ("filter_time", r"^Mutex filter time: (.+)s$", float),
+    ("image_time", r"^Image time: (.+)s$", float),
+    ("peak_memory_kb", r"^Peak memory: (\d+) KB$", int),
+    ("plan_cost", r"^Plan cost: (\d+)$", int),
+    ("utility", r"^Plan utility: (.+)$", float),
+]
+MIN_METRICS = ["plan_cost"]
+
+# Metrics that must not grow: a regression is reported if the new value
+# exceeds factor * baseline + slack.
+GROWTH_THRESHOLDS = {
+    "wall_time": (1.5, 1.0),
+    "total_time": (1.5, 1.0),
+    "search_time": (1.5, 1.0),
+    "filter_time": (1.5, 1.0),
+    "image_time": (1.5, 1.0),
+    "peak_memory_kb": (1.2, 10 * 1024),
+    "expansions": (1.1, 0),
+    "steps": (1.1, 0),
+    "plan_cost": (1.0, 0),
+}
+# Metrics that must not shrink.
+LOWER_BOUNDS = ["utility", "num_plans"]
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.strip())
+    parser.add_argument(
+        "--build", default="release",
+        help="build name or path to the binaries (see fast-downward.py)")
+    parser.add_argument(
+        "--results", default="regression_results.json",
+        help="JSON file with the results of this run")
+    parser.add_argument(
+        "--baseline", default=DEFAULT_BASELINE,
+        help="JSON file with the baseline results")
+    parser.add_argument(
+        "--write-baseline", action="store_true",
+        help="write the results to the baseline file instead of comparing")
+    parser.add_argument(
+        "--time-factor", type=float,
+        help="override the allowed slowdown factor of all time metrics")
+    return parser.parse_args()
+
+
+def run_config(build, task, config):
+    name, domain, problem = task
+    run_dir = tempfile.mkdtemp(prefix="regression-")
+    cmd = [sys.executable, os.path.join(REPO_ROOT_DIR, "fast-downward.py"),
+           "--build", build, "--translate", "--search"] + LIMITS + [
+           os.path.join(TASKS_DIR, domain), os.path.join(TASKS_DIR, problem),
+           "--search", config[1]]
+    start = time.time()
+    process = subprocess.Popen(
+        cmd, cwd=run_dir, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+        universal_newlines=True)
+    output = process.communicate()[0]
+    result = {"exit_code": process.returncode,
+              "wall_time": time.time() - start}
+    for metric, pattern, convert in PATTERNS:
+        values = [convert(value) for value in
+                  re.findall(pattern, output, flags=re.M)]
+        if values:
+            result[metric] = (min(values) if metric in MIN_METRICS
+                              else values[-1])
+    result["num_plans"] = len(
+        glob.glob(os.path.join(run_dir, "found_plans", "sas_plan*")))
+    shutil.rmtree(run_dir)
+    return result
+
+
+def find_regressions(result, baseline, time_factor):
+    regressions = []
+    if result["exit_code"] != baseline["exit_code"]:
+        regressions.append("exit code {} (baseline {})".format(
+            result["exit_code"], baseline["exit_code"]))
+    for metric, (factor, slack) in sorted(GROWTH_THRESHOLDS.items()):
+        if metric not in baseline:
+            continue
+        if time_factor is not None and metric.endswith("time"):
+            factor = time_factor
+        if metric not in result:
+            regressions.append("{} missing".format(metric))
+        elif result[metric] > factor * baseline[metric] + slack:
+            regressions.append("{} {} (baseline {})".format(
+                metric, result[metric], baseline[metric]))
+    for metric in LOWER_BOUNDS:
+        if metric in baseline and result.get(metric, 0) < baseline[metric]:
+            regressions.append("{} {} (baseline {})".format(
+                metric, result.get(metric), baseline[metric]))
+    return regressions
+
+
+def main():
+    args = parse_args()
+    results = {}
+    for task in TASKS:
+        for config in CONFIGS:
+            key = "{}:{}".format(task[0], config[0])
+            print("Running {}...".format(key))
+            sys.stdout.flush()
+            results[key] = run_config(args.build, task, config)
+
+    with open(args.results, "w") as results_file:
+        json.dump(results, results_file, indent=2, sort_keys=True)
+    print("Results written to {}".format(args.results))
+
+    if args.write_baseline:
+        # A failed run would make the comparison accept wrong behavior
+        failed = [key for key, result in sorted(results.items())
+                  if result["exit_code"] != 0 or result["num_plans"] == 0]
+        if failed:
+            print("Baseline not written, runs without a plan: {}".format(
+                ", ".join(failed)))
+            return 1
+        shutil.copy(args.results, args.baseline)
+        print("Baseline written to {}".format(args.baseline))
+        return 0
+
+    with open(args.baseline) as baseline_file:
+        baseline = json.load(baseline_file)
+    num_regressions = 0
+    for key, result in sorted(results.items()):
+        if key not in baseline:
+            print("{}: no baseline".format(key))
+            continue
+        regressions = find_regressions(result, baseline[key], args.time_factor)
+        for regression in regressions:
+            print("REGRESSION {}: {}".format(key, regression))
+        num_regressions += len(regressions)
+    print("{} regression(s) in {} run(s)".format(num_regressions, len(results)))
+    return 1 if num_regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
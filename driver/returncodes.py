@@ -73,6 +73,10 @@ def generate_portfolio_exitcode(exitcodes):
     """
     print("Exit codes: {}".format(exitcodes))
     exitcodes = set(exitcodes)
+    # A search cancelled after finding plans found a plan and ran out of time.
+    if SEARCH_PLAN_FOUND_AND_OUT_OF_TIME in exitcodes:
+        exitcodes.remove(SEARCH_PLAN_FOUND_AND_OUT_OF_TIME)
+        exitcodes.update([SUCCESS, SEARCH_OUT_OF_TIME])
     unrecoverable_codes = [code for code in exitcodes if is_unrecoverable(code)]
 
     # There are unrecoverable exit codes.
@@ -12,6 +12,7 @@ from . import call
 from . import limits
 from . import portfolio_runner
 from . import returncodes
+from . import task_cache
 from . import util
 from .plan_manager import PlanManager
 
@@ -53,6 +54,69 @@ def get_executable(build, rel_path):
     return abs_path
 
 
+# Components whose output is stored in the task cache.
+CACHED_COMPONENTS = ["translate", "preprocess"]
+
+
+def get_cached_components(args):
+    """Return the components whose output is cached in this run, i.e.,
+    the translator and, if it runs, the preprocessor."""
+    if (not args.cache_dir or args.components[0] != "translate" or
+            not args.translate_inputs):
+        return []
+    return [c for c in args.components if c in CACHED_COMPONENTS]
+
+
+def _get_task_cache_and_key(args):
+    components = get_cached_components(args)
+    translate = get_executable(args.build, REL_TRANSLATE_PATH)
+    executables = [os.path.dirname(translate)]
+    options = [args.translate_options]
+    if "preprocess" in components:
+        executables.append(get_executable(args.build, REL_PREPROCESS_PATH))
+        options.append(args.preprocess_options)
+    key = task_cache.compute_key(
+        components, args.translate_inputs, options, executables)
+    cache = task_cache.TaskCache(args.cache_dir, args.cache_size_limit)
+    return cache, key
+
+
+def restore_cached_task(args):
+    """Copy the cached output of the cached components to the translator
+    output file. Return True on a cache hit."""
+    cache, key = _get_task_cache_and_key(args)
+    if cache.lookup(key, args.sas_file):
+        logging.info("Task cache hit: %s" % key)
+        return True
+    logging.info("Task cache miss: %s" % key)
+    return False
+
+
+def store_cached_task(args):
+    cache, key = _get_task_cache_and_key(args)
+    cache.store(key, args.sas_file)
+    logging.info("Task stored in cache: %s" % key)
+
+
+def set_plan_bound(sas_file, bound):
+    """Set the bound section of a translator output file, adding it after
+    the utilities (or the goal) if the file has none."""
+    with open(sas_file) as input_file:
+        lines = input_file.read().splitlines()
+    if "begin_bound" in lines:
+        pos = lines.index("begin_bound")
+        lines[pos + 1] = str(bound)
+    else:
+        anchor = "end_util" if "end_util" in lines else "end_goal"
+        if anchor not in lines:
+            returncodes.exit_with_driver_input_error(
+                "Cannot set the plan bound of {}: no goal found.".format(sas_file))
+        pos = lines.index(anchor) + 1
+        lines[pos:pos] = ["begin_bound", str(bound), "end_bound"]
+    with open(sas_file, "w") as output_file:
+        output_file.write("\n".join(lines) + "\n")
+
+
 def run_translate(args):
     logging.info("Running translator.")
     time_limit = limits.get_time_limit(
@@ -126,6 +190,10 @@ def run_search(args):
         args.search_memory_limit, args.overall_memory_limit)
     executable = get_executable(args.build, REL_SEARCH_PATH)
 
+    if args.plan_bound is not None:
+        logging.info("Setting plan bound to %d." % args.plan_bound)
+        set_plan_bound(args.search_input, args.plan_bound)
+
     plan_manager = PlanManager(
         args.plan_file,
         portfolio_bound=args.portfolio_bound,
@@ -152,11 +220,11 @@ def run_search(args):
                 time_limit=time_limit,
                 memory_limit=memory_limit)
         except subprocess.CalledProcessError as err:
-            # TODO: if we ever add support for SEARCH_PLAN_FOUND_AND_* directly
-            # in the planner, this assertion no longer holds. Furthermore, we
-            # would need to return (err.returncode, True) if the returncode is
-            # in [0..10].
+            # Symbolic searches that are cancelled by a signal exit with
+            # SEARCH_PLAN_FOUND_AND_OUT_OF_TIME if they found some plans.
             # Negative exit codes are allowed for passing out signals.
+            if err.returncode == returncodes.SEARCH_PLAN_FOUND_AND_OUT_OF_TIME:
+                return (err.returncode, True)
             assert err.returncode >= 10 or err.returncode < 0, "got returncode < 10: {}".format(err.returncode)
             return (err.returncode, False)
         else:
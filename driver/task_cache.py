@@ -0,0 +1,161 @@
+# -*- coding: utf-8 -*-
+
+"""
+On-disk cache of translator/preprocessor outputs. Entries are keyed by a
+hash of the PDDL inputs, the component options and the executables that
+produced them, and are evicted in least-recently-used order once the
+cache exceeds its size limit.
+
+Several planner processes may share a cache directory: entries are
+written to a temporary file and renamed into place atomically, readers
+copy entries before using them, and concurrent evictions are tolerated.
+"""
+
+from __future__ import print_function
+
+import hashlib
+import logging
+import os
+import shutil
+import tempfile
+import time
+
+# Increase when the key or the entry format changes.
+CACHE_VERSION = 1
+ENTRY_SUFFIX = ".sas"
+TEMP_PREFIX = "tmp-"
+# Temporary files of crashed writers are removed after this many seconds.
+STALE_TEMP_AGE = 3600
+
+
+def _hash_file(hasher, path):
+    with open(path, "rb") as f:
+        for block in iter(lambda: f.read(1 << 20), b""):
+            hasher.update(block)
+
+
+def _hash_string(hasher, s):
+    # Length-prefixed to keep different sequences of strings apart.
+    data = s.encode("utf-8")
+    hasher.update(str(len(data)).encode("ascii") + b":" + data)
+
+
+def _python_modules(path):
+    """All Python modules in the directory tree of path (including the
+    subpackages), in a fixed order."""
+    modules = []
+    for dirpath, dirnames, filenames in os.walk(path):
+        dirnames.sort()
+        modules.extend(os.path.join(dirpath, filename)
+                       for filename in sorted(filenames)
+                       if filename.endswith(".py"))
+    return modules
+
+
+def _fingerprint(hasher, path):
+    """Identify an executable (or a directory tree of Python modules) by
+    the path, size and modification time of its files."""
+    if os.path.isdir(path):
+        paths = _python_modules(path)
+    else:
+        paths = [path]
+    for p in paths:
+        stat = os.stat(p)
+        _hash_string(hasher, "{}:{}:{}".format(
+            os.path.abspath(p), stat.st_size, stat.st_mtime))
+
+
+def compute_key(components, inputs, options, executables):
+    """
+    components: names of the cached components in the order they run.
+    inputs: input files whose contents are part of the key.
+    options: list of option lists, one per component.
+    executables: files or directories that implement the components.
+    """
+    hasher = hashlib.sha256()
+    _hash_string(hasher, str(CACHE_VERSION))
+    for component in components:
+        _hash_string(hasher, component)
+    for path in inputs:
+        _hash_file(hasher, path)
+    for component_options in options:
+        _hash_string(hasher, str(len(component_options)))
+        for option in component_options:
+            _hash_string(hasher, option)
+    for path in executables:
+        _fingerprint(hasher, path)
+    return hasher.hexdigest()
+
+
+def _remove(path):
+    try:
+        os.remove(path)
+    except OSError:
+        # Removed concurrently by another process.
+        pass
+
+
+class TaskCache(object):
+    def __init__(self, cache_dir, size_limit):
+        self.cache_dir = cache_dir
+        self.size_limit = size_limit
+        try:
+            os.makedirs(cache_dir)
+        except OSError:
+            if not os.path.isdir(cache_dir):
+                raise
+
+    def _entry_path(self, key):
+        return os.path.join(self.cache_dir, key + ENTRY_SUFFIX)
+
+    def lookup(self, key, dest):
+        """Copy the entry of key to dest. Return False on a miss."""
+        entry = self._entry_path(key)
+        try:
+            shutil.copyfile(entry, dest)
+            # The modification time marks the last use for the eviction.
+            os.utime(entry, None)
+        except (IOError, OSError):
+            return False
+        return True
+
+    def store(self, key, src):
+        """Store a copy of src as entry of key and evict old entries."""
+        fd, tmp_path = tempfile.mkstemp(
+            prefix=TEMP_PREFIX, suffix=ENTRY_SUFFIX, dir=self.cache_dir)
+        os.close(fd)
+        try:
+            shutil.copyfile(src, tmp_path)
+            os.rename(tmp_path, self._entry_path(key))
+        except (IOError, OSError) as err:
+            # E.g., on Windows, rename fails if another process stored
+            # the same entry in the meantime.
+            logging.warning("Could not store cache entry: {}".format(err))
+            _remove(tmp_path)
+            return
+        self.evict()
+
+    def evict(self):
+        """Remove least recently used entries until the cache fits into
+        its size limit."""
+        entries = []
+        total_size = 0
+        now = time.time()
+        for name in os.listdir(self.cache_dir):
+            path = os.path.join(self.cache_dir, name)
+            try:
+                stat = os.stat(path)
+            except OSError:
+                continue
+            if name.startswith(TEMP_PREFIX):
+                if now - stat.st_mtime > STALE_TEMP_AGE:
+                    _remove(path)
+            elif name.endswith(ENTRY_SUFFIX):
+                entries.append((stat.st_mtime, stat.st_size, path))
+                total_size += stat.st_size
+        for _, size, path in sorted(entries):
+            if total_size <= self.size_limit:
+                break
+            logging.info("Evicting cache entry {}".format(path))
+            _remove(path)
+            total_size -= size
@@ -5,11 +5,139 @@
 //#include "utilities.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
 #include <vector>
 #include <set>
 
 using namespace std;
 
+namespace {
+typedef uint64_t Word;
+const unsigned WORD_BITS = 64;
+
+/*
+  Bitset over the pairs of propositions: bit q of row p represents the
+  pair (p, q). Bits are set with atomic ORs so that several threads can
+  apply operators concurrently. Since the h^2 fixpoint only adds reached
+  pairs, the result does not depend on the order in which they are set.
+*/
+class PairBitset {
+    unsigned num_props;
+    unsigned num_words;
+    unique_ptr<atomic<Word>[]> bits;
+    // Bit p is set iff the pair (p, p) is set
+    unique_ptr<atomic<Word>[]> diagonal;
+
+public:
+    explicit PairBitset(unsigned num_props)
+        : num_props(num_props), num_words((num_props + WORD_BITS - 1) / WORD_BITS),
+          bits(new atomic<Word>[size_t(num_props) * num_words]()),
+          diagonal(new atomic<Word>[num_words]()) {
+    }
+
+    unsigned words() const {
+        return num_words;
+    }
+
+    Word get_word(unsigned row, unsigned w) const {
+        return bits[size_t(row) * num_words + w].load(memory_order_relaxed);
+    }
+
+    Word get_diagonal_word(unsigned w) const {
+        return diagonal[w].load(memory_order_relaxed);
+    }
+
+    bool test(unsigned p, unsigned q) const {
+        return (get_word(p, q / WORD_BITS) >> (q % WORD_BITS)) & 1;
+    }
+
+    // Sets (p, q) and (q, p); returns false if they were already set
+    bool set_symmetric(unsigned p, unsigned q) {
+        Word mask = Word(1) << (q % WORD_BITS);
+        Word old = bits[size_t(p) * num_words + q / WORD_BITS].fetch_or(mask, memory_order_relaxed);
+        bits[size_t(q) * num_words + p / WORD_BITS].fetch_or(
+            Word(1) << (p % WORD_BITS), memory_order_relaxed);
+        if (p == q)
+            diagonal[p / WORD_BITS].fetch_or(mask, memory_order_relaxed);
+        return !(old & mask);
+    }
+};
+
+inline unsigned lowest_bit(Word word) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    unsigned bit = 0;
+    while (!((word >> bit) & 1))
+        bit++;
+    return bit;
+#endif
+}
+
+inline void clear_bit(vector<Word> &row, unsigned p) {
+    row[p / WORD_BITS] &= ~(Word(1) << (p % WORD_BITS));
+}
+
+/*
+  Applies one operator to the reached pairs (see the description of
+  H2Mutexes::compute). open has the bits of the pairs that are not
+  spurious; scratch is a row of the caller used as temporary storage.
+  Returns true if a new pair was reached.
+*/
+bool apply_operator(Op_h2 &op, PairBitset &reached, const vector<Word> &open,
+                    vector<Word> &scratch) {
+    if (op.triggered == SPURIOUS)
+        return false;
+
+    // if the preconditions haven't been met, return
+    if (op.triggered != REACHED) {
+        for (unsigned i = 0; i < op.pre.size(); i++)
+            for (unsigned j = i; j < op.pre.size(); j++)
+                if (!reached.test(op.pre[i], op.pre[j]))
+                    return false;
+        op.triggered = REACHED;
+    }
+
+    unsigned num_words = reached.words();
+    bool updated = false;
+    for (unsigned p : op.add) {
+        for (unsigned q : op.add) {
+            size_t open_word = size_t(p) * num_words + q / WORD_BITS;
+            if ((open[open_word] >> (q % WORD_BITS)) & 1)
+                updated |= reached.set_symmetric(p, q);
+        }
+    }
+
+    // Propositions that are reached, reached with every precondition and
+    // neither added nor deleted by the operator
+    for (unsigned w = 0; w < num_words; w++)
+        scratch[w] = reached.get_diagonal_word(w);
+    for (unsigned pre : op.pre)
+        for (unsigned w = 0; w < num_words; w++)
+            scratch[w] &= reached.get_word(pre, w);
+    for (unsigned p : op.add)
+        clear_bit(scratch, p);
+    for (unsigned p : op.del)
+        clear_bit(scratch, p);
+
+    for (unsigned p : op.add) {
+        const Word *open_row = &open[size_t(p) * num_words];
+        for (unsigned w = 0; w < num_words; w++) {
+            Word new_pairs = scratch[w] & open_row[w] & ~reached.get_word(p, w);
+            while (new_pairs) {
+                unsigned bit = lowest_bit(new_pairs);
+                new_pairs &= new_pairs - 1;
+                updated |= reached.set_symmetric(p, w * WORD_BITS + bit);
+            }
+        }
+    }
+    return updated;
+}
+}
+
 Op_h2::Op_h2(const Operator &op,
              const vector< vector<unsigned>> &p_index,
              const vector<vector<set<pair<int, int>>>> &inconsistent_facts,
@@ -44,8 +172,9 @@ bool compute_h2_mutexes(const vector <Variable *> &variables,
                         vector<MutexGroup> &mutexes,
                         State &initial_state,
                         const vector<pair<Variable *, int>> &goals,
-                        int limit_seconds, bool disable_bw_h2) {
-    H2Mutexes h2(limit_seconds);
+                        int limit_seconds, bool disable_bw_h2,
+                        int num_threads) {
+    H2Mutexes h2(limit_seconds, num_threads);
 
     if (!h2.initialize(variables, mutexes)) {
         return true;
@@ -187,13 +316,34 @@ bool  H2Mutexes::set_unreachable(int var, int val, const vector <Variable *> &va
 
 
 bool H2Mutexes::remove_spurious_operators(vector<Operator> &operators) {
+    vector<bool> was_redundant(operators.size());
+    for (size_t i = 0; i < operators.size(); i++)
+        was_redundant[i] = operators[i].is_redundant();
+
+    // Operators are disambiguated independently of each other
+    atomic<size_t> next_op(0);
+    auto disambiguate = [&]() {
+        for (size_t i = next_op++; i < operators.size(); i = next_op++) {
+            if (!was_redundant[i])
+                operators[i].remove_ambiguity(*this);
+        }
+    };
+    if (num_threads > 1) {
+        vector<thread> workers;
+        for (int i = 0; i < num_threads; i++)
+            workers.emplace_back(disambiguate);
+        for (thread &worker : workers)
+            worker.join();
+    } else {
+        disambiguate();
+    }
+
     int count = 0, totalCount = 0;
     bool spurious_detected = false;
-    for (Operator &op : operators) {
-        if (!op.is_redundant()) {
+    for (size_t i = 0; i < operators.size(); i++) {
+        if (!was_redundant[i]) {
             totalCount++;
-            op.remove_ambiguity(*this);
-            if (op.is_redundant()) {
+            if (operators[i].is_redundant()) {
                 spurious_detected = true;
                 count++;
             }
@@ -473,68 +623,8 @@ int H2Mutexes::compute(const vector <Variable *> &variables,
 
     cout << "Computing mutexes..." << endl;
 
-    bool updated;
-    do {
-        // if (time_exceeded())
-        //     return TIMEOUT;
-	
-        updated = false;
-        for (unsigned op_i = 0; op_i < m_ops.size(); op_i++) {
-	    if (op_i % 10000 == 0 && time_exceeded()) return TIMEOUT; 
-
-            // disregard spurious operators
-            if (m_ops[op_i].triggered == SPURIOUS)
-                continue;
-
-            // if the preconditions haven't been met, continue
-            if ((m_ops[op_i].triggered != REACHED) &&
-                ((m_ops[op_i].triggered =
-                      eval_propositions(m_ops[op_i].pre)) != REACHED))
-                continue;
-
-
-            for (unsigned add_i = 0; add_i < m_ops[op_i].add.size(); add_i++) {
-                unsigned p = m_ops[op_i].add[add_i];
-                for (unsigned add_j = 0; add_j < m_ops[op_i].add.size(); add_j++) {
-                    unsigned q = m_ops[op_i].add[add_j];
-                    if (m_values[position(p, q)] == NOT_REACHED) {
-                        m_values[position(p, q)] = m_values[position(q, p)] = REACHED;
-                        updated = true;
-                    }
-                }
-
-
-                for (unsigned prop_i = 0; prop_i < number_props; prop_i++) {
-                    if (m_values[position(prop_i, prop_i)] != REACHED ||
-                        m_values[position(p, prop_i)] != NOT_REACHED)
-                        continue;
-
-                    if (binary_search(m_ops[op_i].add.begin(),
-                                      m_ops[op_i].add.end(),
-                                      prop_i) ||
-                        binary_search(m_ops[op_i].del.begin(),
-                                      m_ops[op_i].del.end(),
-                                      prop_i)) {
-                        continue;
-                    }
-
-                    bool satisfied = true;
-                    for (unsigned pre_i = 0; satisfied && pre_i < m_ops[op_i].pre.size(); pre_i++) {
-                        satisfied = (m_values[position(prop_i, m_ops[op_i].pre[pre_i])] == REACHED);
-                    }
-
-                    if (satisfied) {
-                        // pair<unsigned, unsigned> a = p_index_reverse[prop_i];
-                        // pair<unsigned, unsigned> b = p_index_reverse[p];
-                        // cout << "Action: " << g_operators[op_i].get_name() << " -> ";
-                        // cout << print_fluent(a.first,a.second) << " - " << print_fluent(b.first,b.second) << endl;
-                        m_values[position(p, prop_i)] = m_values[position(prop_i, p)] = REACHED;
-                        updated = true;
-                    }
-                }
-            }
-        }
-    } while (updated);
+    if (!compute_fixpoint())
+        return TIMEOUT;
 
     int countReached = 0, countNotReached = 0, countSpurious = 0;
     for (unsigned i = 0; i < m_values.size(); i++) {
@@ -613,14 +703,84 @@ int H2Mutexes::compute(const vector <Variable *> &variables,
     return count + countUnreachable;
 }
 
-Reachability H2Mutexes::eval_propositions(const vector<unsigned> & props) {
-    if (props.empty())
-        return REACHED;
-    for (unsigned i = 0; i < props.size(); i++)
-        for (unsigned j = i; j < props.size(); j++)
-            if (m_values[position(props[i], props[j])] == NOT_REACHED)
-                return NOT_REACHED;
-    return REACHED;
+/*
+  An operator is triggered once all pairs of its preconditions are
+  reached. Then, every pair of its adds is reached, and so is every pair
+  (p, q) of an add p and a reached proposition q that is neither added
+  nor deleted and that is reached together with all preconditions.
+
+  The fixpoint works on a bitset copy of m_values, so that the pairs of
+  an add are updated by word-level ANDs of the rows of the preconditions.
+  The sweeps over the operators are partitioned among num_threads
+  threads. The result is the same least fixpoint for any number of
+  threads.
+*/
+bool H2Mutexes::compute_fixpoint() {
+    PairBitset reached(number_props);
+    unsigned num_words = reached.words();
+    vector<Word> open(size_t(number_props) * num_words, 0);
+    for (unsigned p = 0; p < number_props; p++) {
+        for (unsigned q = 0; q < number_props; q++) {
+            Reachability value = static_cast<Reachability>(m_values[position(p, q)]);
+            if (value == REACHED)
+                reached.set_symmetric(p, q);
+            if (value != SPURIOUS)
+                open[size_t(p) * num_words + q / WORD_BITS] |= Word(1) << (q % WORD_BITS);
+        }
+    }
+
+    const unsigned ops_per_chunk = 64;
+    bool timeout = false;
+    bool updated;
+    do {
+        atomic<unsigned> next_chunk(0);
+        atomic<bool> sweep_updated(false);
+        atomic<bool> sweep_timeout(false);
+        auto sweep = [&]() {
+            vector<Word> scratch(num_words);
+            bool local_updated = false;
+            unsigned processed = 0;
+            while (!sweep_timeout.load(memory_order_relaxed)) {
+                unsigned begin = next_chunk.fetch_add(1) * ops_per_chunk;
+                if (begin >= m_ops.size())
+                    break;
+                unsigned end = min<unsigned>(begin + ops_per_chunk, m_ops.size());
+                for (unsigned op_i = begin; op_i < end; op_i++)
+                    local_updated |= apply_operator(m_ops[op_i], reached, open, scratch);
+                processed += end - begin;
+                if (processed >= 10000) {
+                    processed = 0;
+                    if (time_limit_reached())
+                        sweep_timeout = true;
+                }
+            }
+            if (local_updated)
+                sweep_updated = true;
+        };
+
+        if (num_threads > 1) {
+            vector<thread> workers;
+            for (int i = 0; i < num_threads; i++)
+                workers.emplace_back(sweep);
+            for (thread &worker : workers)
+                worker.join();
+        } else {
+            sweep();
+        }
+        updated = sweep_updated;
+        timeout = sweep_timeout || time_limit_reached();
+    } while (updated && !timeout);
+
+    for (unsigned p = 0; p < number_props; p++) {
+        for (unsigned q = 0; q < number_props; q++) {
+            unsigned pos = position(p, q);
+            if (m_values[pos] != SPURIOUS)
+                m_values[pos] = reached.test(p, q) ? REACHED : NOT_REACHED;
+        }
+    }
+    if (timeout)
+        time_exceeded();
+    return !timeout;
 }
 
 void H2Mutexes::print_mutexes(const vector <Variable *> &variables) {
@@ -644,11 +804,14 @@ void H2Mutexes::print_pair(unsigned /*pair*/) {
     //cout << g_fact_names[a.first][a.second] << " related to " << g_fact_names[a.first][0] << " - " << g_fact_names[b.first][b.second] << " related to " << g_fact_names[b.first][0] << endl;
 }
 
-bool H2Mutexes::time_exceeded() {
+bool H2Mutexes::time_limit_reached() const {
     if (limit_seconds == -1) // no limit
         return false;
+    return difftime(time(NULL), start) > limit_seconds;
+}
 
-    if (difftime(time(NULL), start) > limit_seconds) {
+bool H2Mutexes::time_exceeded() {
+    if (time_limit_reached()) {
         cout << "h^mutexes could not be computed (building time)" << endl;
         return true;
     }
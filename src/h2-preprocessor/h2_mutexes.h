@@ -61,7 +61,7 @@ class H2Mutexes {
 
     bool check_goal_state_is_unreachable(const vector<pair<Variable *, int>> &goal) const;
 public:
-    H2Mutexes(int t = -1) : limit_seconds(t) {
+    H2Mutexes(int t = -1, int threads = 1) : limit_seconds(t), num_threads(threads) {
         if (limit_seconds != -1)
             time(&start);
     }
@@ -126,8 +126,6 @@ protected:
     vector< vector<unsigned>> p_index;
     vector< pair<unsigned, unsigned>> p_index_reverse;
 
-    Reachability eval_propositions(const vector<unsigned> & props);
-
     inline unsigned position(unsigned a, unsigned b) const {
         return (a * number_props) + b;
     }
@@ -139,9 +137,14 @@ protected:
     void print_pair(unsigned pair);
 
     int limit_seconds;
+    int num_threads;
     time_t start;
+    bool time_limit_reached() const;
     bool time_exceeded();
 
+    // Runs the h^2 fixpoint over m_ops; returns false on timeout
+    bool compute_fixpoint();
+
     bool init_values_progression(const vector <Variable *> &variables,
                                  const State &initial_state);
     bool init_values_regression(const vector<pair<Variable *, int>> &goal);
@@ -158,7 +161,8 @@ extern bool compute_h2_mutexes(const vector <Variable *> &variables,
                                vector<MutexGroup> &mutexes,
                                State &initial_state,
                                const vector<pair<Variable *, int>> &goal,
-                               int limit_seconds, bool disable_bw_h2);
+                               int limit_seconds, bool disable_bw_h2,
+                               int num_threads = 1);
 
 
 
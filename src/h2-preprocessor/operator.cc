@@ -163,18 +163,23 @@ void Operator::remove_ambiguity(const H2Mutexes &h2) {
     }
 
     // check that no precondition is unreachable or mutex with some other precondition
+    vector<int> precondition_vars;
     for (size_t i = 0; i < preconditions.size(); i++) {
-        if (preconditions[i] != -1) {
-            if (h2.is_unreachable(i, preconditions[i])) {
+        if (preconditions[i] != -1)
+            precondition_vars.push_back(i);
+    }
+    for (size_t i = 0; i < precondition_vars.size(); i++) {
+        int var1 = precondition_vars[i];
+        if (h2.is_unreachable(var1, preconditions[var1])) {
+            spurious = true;
+            return;
+        }
+        for (size_t j = i + 1; j < precondition_vars.size(); j++) {
+            int var2 = precondition_vars[j];
+            if (h2.are_mutex(var1, preconditions[var1], var2, preconditions[var2])) {
                 spurious = true;
                 return;
             }
-            for (size_t j = i + 1; j < preconditions.size(); j++) {
-                if (h2.are_mutex(i, preconditions[i], j, preconditions[j])) {
-                    spurious = true;
-                    return;
-                }
-            }
         }
     }
 
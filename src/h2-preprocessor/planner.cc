@@ -24,6 +24,7 @@ int main(int argc, const char **argv) {
     bool include_augmented_preconditions = false;
     bool expensive_statistics = false;
     bool disable_bw_h2 = false;
+    int h2_threads = 1;
 
     bool metric;
     vector<Variable *> variables;
@@ -53,6 +54,14 @@ int main(int argc, const char **argv) {
                 cerr << "please specify the number of seconds after --h2_time_limit" << endl;
                 exit(2);
             }
+        } else if (arg.compare("--h2_threads") == 0) {
+            i++;
+            if (i < argc && atoi(argv[i]) > 0) {
+                h2_threads = atoi(argv[i]);
+            } else {
+                cerr << "please specify a positive number of threads after --h2_threads" << endl;
+                exit(2);
+            }
         } else if (arg.compare("--no_h2") == 0) {
             h2_mutex_time = 0;
         } else if (arg.compare("--augmented_pre") == 0) {
@@ -63,7 +72,7 @@ int main(int argc, const char **argv) {
             expensive_statistics = true;
         } else {
             cerr << "unknown option " << arg << endl << endl;
-            cout << "Usage: ./preprocess [--no_rel] [--no_h2]  [--no_bw_h2] [--augmented_pre] [--stat] < output" << endl;
+            cout << "Usage: ./preprocess [--no_rel] [--no_h2]  [--no_bw_h2] [--h2_threads N] [--augmented_pre] [--stat] < output" << endl;
             exit(2);
         }
     }
@@ -100,7 +109,7 @@ int main(int argc, const char **argv) {
 
         if(!compute_h2_mutexes(ordering, operators, axioms,
                            mutexes, initial_state, goals,
-			       h2_mutex_time, disable_bw_h2)){
+			       h2_mutex_time, disable_bw_h2, h2_threads)){
 	                // TODO: don't duplicate the code to return an unsolvable task, log and exit here
             cout << "Unsolvable task in preprocessor" << endl;
             generate_unsolvable_cpp_input();
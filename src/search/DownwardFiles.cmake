@@ -68,6 +68,7 @@ fast_downward_plugin(
         per_state_bitset
         per_state_information
         per_task_information
+        plan_archive
         plan_manager
         plugin
         pruning_method
@@ -353,6 +354,7 @@ fast_downward_plugin(
     SOURCES
         search_engines/eager_search
         search_engines/eager_osp_search
+        search_engines/eager_osp_bdd_search
     DEPENDS NULL_PRUNING_METHOD ORDERED_SET SUCCESSOR_GENERATOR
     DEPENDENCY_ONLY
 )
@@ -543,6 +545,7 @@ fast_downward_plugin(
         tasks/cost_adapted_task
         tasks/delegating_task
         tasks/root_task
+        tasks/binary_root_task
     CORE_PLUGIN
 )
 
@@ -768,11 +771,16 @@ fast_downward_plugin(
         symbolic/sym_state_space_manager
         symbolic/transition_relation
         symbolic/original_state_space
+        symbolic/sym_tr_cache
+        symbolic/sym_state_space_cache
         symbolic/sym_params_search
         symbolic/sym_estimate
+        symbolic/sym_trace
+        symbolic/sym_memory_timeline
         symbolic/frontier
         symbolic/open_list
         symbolic/closed_list
+        symbolic/explicit_closed_list
         symbolic/searches/bidirectional_search
         symbolic/searches/uniform_cost_search
         symbolic/searches/sym_search
@@ -783,8 +791,10 @@ fast_downward_plugin(
         symbolic/search_engines/top_k_symbolic_uniform_cost_search
         symbolic/search_engines/osp_symbolic_uniform_cost_search
         symbolic/search_engines/top_q_symbolic_uniform_cost_search
+        symbolic/search_engines/hybrid_symbolic_uniform_cost_search
         symbolic/plan_reconstruction/sym_solution_cut
         symbolic/plan_reconstruction/sym_solution_registry
+        symbolic/plan_reconstruction/sym_plan_counter
         symbolic/plan_selection/plan_database
         symbolic/plan_selection/top_k_selector
         symbolic/plan_selection/top_k_even_selector
@@ -1,6 +1,7 @@
 #include "command_line.h"
 
 #include "option_parser.h"
+#include "plan_archive.h"
 #include "plan_manager.h"
 #include "search_engine.h"
 
@@ -44,6 +45,8 @@ static int parse_int_arg(const string &name, const string &value) {
 static shared_ptr<SearchEngine> parse_cmd_line_aux(
     const vector<string> &args, options::Registry &registry, bool dry_run) {
     string plan_filename = "sas_plan";
+    string plan_archive;
+    int plan_archive_compression = 0;
     int num_previously_generated_plans = 0;
     bool is_part_of_anytime_portfolio = false;
     options::Predefinitions predefinitions;
@@ -97,6 +100,26 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(
                 throw ArgError("missing argument after --internal-plan-file");
             ++i;
             plan_filename = args[i];
+        } else if (arg == "--plan-archive") {
+            if (is_last)
+                throw ArgError("missing argument after --plan-archive");
+            ++i;
+            plan_archive = args[i];
+        } else if (arg == "--plan-archive-compression") {
+            if (is_last)
+                throw ArgError("missing argument after --plan-archive-compression");
+            ++i;
+            plan_archive_compression = parse_int_arg(arg, args[i]);
+            if (plan_archive_compression < 0 || plan_archive_compression > 9)
+                throw ArgError("argument for --plan-archive-compression must be in 0..9");
+            if (plan_archive_compression > 0 &&
+                !PlanArchiveWriter::supports_compression())
+                throw ArgError("--plan-archive-compression needs a planner built with zlib");
+        } else if (arg == "--binary-task" || arg == "--write-binary-task") {
+            // Handled before reading the task (see planner.cc).
+            if (is_last)
+                throw ArgError("missing argument after " + arg);
+            ++i;
         } else if (arg == "--internal-previous-portfolio-plans") {
             if (is_last)
                 throw ArgError("missing argument after --internal-previous-portfolio-plans");
@@ -123,6 +146,10 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(
         plan_manager.set_plan_filename(plan_filename);
         plan_manager.set_num_previously_generated_plans(num_previously_generated_plans);
         plan_manager.set_is_part_of_anytime_portfolio(is_part_of_anytime_portfolio);
+        if (!plan_archive.empty() && !dry_run) {
+            plan_manager.set_plan_sink(make_shared<PlanArchiveWriter>(
+                plan_archive, plan_archive_compression));
+        }
     }
     return engine;
 }
@@ -165,6 +192,17 @@ string usage(const string &progname) {
            "--evaluator EVALUATOR_PREDEFINITION\n"
            "    Predefines an evaluator that can afterwards be referenced\n"
            "    by the name that is specified in the definition.\n"
+           "--binary-task FILENAME\n"
+           "    Maps the task from the binary file FILENAME instead of reading\n"
+           "    the translator output from stdin.\n"
+           "--write-binary-task FILENAME\n"
+           "    Writes the task read from stdin to the binary file FILENAME\n"
+           "    and exits without searching.\n"
+           "--plan-archive FILENAME\n"
+           "    Writes all plans to the binary archive FILENAME instead of\n"
+           "    one text file per plan (see driver/plan_archive.py).\n"
+           "--plan-archive-compression LEVEL\n"
+           "    zlib compression level (0-9) of the plan archive (default: 0).\n"
            "--internal-plan-file FILENAME\n"
            "    Plan will be output to a file called FILENAME\n\n"
            "--internal-previous-portfolio-plans COUNTER\n"
@@ -27,6 +27,11 @@ MutexGroup::MutexGroup(istream &in) {
   exactly_one = (exactly_one_str == "exactly_one");
   detected_fw = (dir == "fw");
 }
+
+MutexGroup::MutexGroup(vector<FactPair> &&facts, bool exactly_one,
+                       bool detected_fw)
+  : detected_fw(detected_fw), exactly_one(exactly_one), facts(move(facts)) {
+}
  
 bool MutexGroup::hasPair(int var, int val) const{
   for(size_t i = 0; i < facts.size(); ++i){
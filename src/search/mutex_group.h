@@ -13,6 +13,7 @@ class MutexGroup {
   std::vector<FactPair> facts;
  public:
   MutexGroup(std::istream &in);
+  MutexGroup(std::vector<FactPair> &&facts, bool exactly_one, bool detected_fw);
 
   void dump() const;
 
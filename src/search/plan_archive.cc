@@ -0,0 +1,140 @@
+#include "plan_archive.h"
+
+#include "task_proxy.h"
+
+#include "task_utils/task_properties.h"
+#include "utils/system.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+static const char MAGIC[] = {'F', 'D', 'P', 'A'};
+
+bool PlanArchiveWriter::supports_compression() {
+#ifdef USE_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+PlanArchiveWriter::PlanArchiveWriter(const string &filename,
+                                     int compression_level)
+    : filename(filename), file(fopen(filename.c_str(), "wb")),
+      compression_level(compression_level), wrote_operators(false) {
+  if (!file) {
+    cerr << "Failed to open plan archive: " << filename << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+  }
+  if (compression_level > 0) {
+#ifdef USE_ZLIB
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    if (deflateInit(&stream, compression_level) != Z_OK) {
+      cerr << "Failed to initialize the compression of " << filename << endl;
+      utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+#else
+    cerr << "Compressed plan archives need zlib" << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+#endif
+  }
+  unsigned char header[] = {static_cast<unsigned char>(VERSION),
+                            static_cast<unsigned char>(compression_level > 0)};
+  write_raw(MAGIC, sizeof(MAGIC));
+  write_raw(header, sizeof(header));
+  fflush(file);
+  cout << "Writing plans to archive " << filename << endl;
+}
+
+PlanArchiveWriter::~PlanArchiveWriter() {
+#ifdef USE_ZLIB
+  if (compression_level > 0) {
+    // Terminates the zlib stream
+    unsigned char out[1 << 14];
+    int ret;
+    do {
+      stream.next_in = Z_NULL;
+      stream.avail_in = 0;
+      stream.next_out = out;
+      stream.avail_out = sizeof(out);
+      ret = deflate(&stream, Z_FINISH);
+      write_raw(out, sizeof(out) - stream.avail_out);
+    } while (ret == Z_OK);
+    deflateEnd(&stream);
+  }
+#endif
+  fclose(file);
+}
+
+void PlanArchiveWriter::write_raw(const void *data, size_t size) {
+  if (size > 0 && fwrite(data, 1, size, file) != size) {
+    cerr << "Failed to write plan archive: " << filename << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+  }
+}
+
+void PlanArchiveWriter::write_varint(size_t value) {
+  while (value >= 0x80) {
+    buffer.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  buffer.push_back(static_cast<char>(value));
+}
+
+void PlanArchiveWriter::write_operators(const TaskProxy &task_proxy) {
+  OperatorsProxy operators = task_proxy.get_operators();
+  write_varint(operators.size());
+  for (OperatorProxy op : operators) {
+    string name = op.get_name();
+    write_varint(name.size());
+    buffer += name;
+    write_varint(op.get_cost());
+  }
+  write_varint(task_properties::is_unit_cost(task_proxy));
+  wrote_operators = true;
+}
+
+void PlanArchiveWriter::flush_buffer() {
+  if (compression_level == 0) {
+    write_raw(buffer.data(), buffer.size());
+  } else {
+#ifdef USE_ZLIB
+    unsigned char out[1 << 14];
+    stream.next_in =
+        reinterpret_cast<Bytef *>(const_cast<char *>(buffer.data()));
+    stream.avail_in = buffer.size();
+    // A sync flush makes the plan readable without ending the stream
+    do {
+      stream.next_out = out;
+      stream.avail_out = sizeof(out);
+      deflate(&stream, Z_SYNC_FLUSH);
+      write_raw(out, sizeof(out) - stream.avail_out);
+    } while (stream.avail_out == 0);
+#endif
+  }
+  buffer.clear();
+  fflush(file);
+}
+
+void PlanArchiveWriter::save_plan(const Plan &plan,
+                                  const TaskProxy &task_proxy) {
+  if (!wrote_operators) {
+    write_operators(task_proxy);
+  }
+  auto mismatch_pos = mismatch(
+      previous_plan.begin(),
+      previous_plan.begin() + min(previous_plan.size(), plan.size()),
+      plan.begin());
+  size_t shared_prefix = mismatch_pos.first - previous_plan.begin();
+  write_varint(shared_prefix);
+  write_varint(plan.size() - shared_prefix);
+  for (size_t i = shared_prefix; i < plan.size(); ++i) {
+    write_varint(plan[i].get_index());
+  }
+  flush_buffer();
+  previous_plan = plan;
+}
@@ -0,0 +1,62 @@
+#ifndef PLAN_ARCHIVE_H
+#define PLAN_ARCHIVE_H
+
+#include "plan_manager.h"
+
+#include <cstdio>
+#include <string>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+/*
+  Plan sink that streams all plans into a single binary archive instead of
+  creating one text file per plan.
+
+  All integers are unsigned LEB128 varints. The file starts with the
+  uncompressed header
+
+    "FDPA" version compression
+
+  followed by the (possibly zlib-compressed) body
+
+    num_operators {name_length name cost}* is_unit_cost
+    {shared_prefix suffix_length operator_index*}*
+
+  with one record per plan. shared_prefix is the number of leading operators
+  the plan shares with the previous plan; only the remaining operators are
+  stored. The operator table is written with the first plan.
+
+  The body is flushed after every plan, so all plans written before the
+  planner is killed can be read. driver/plan_archive.py lists archives and
+  converts them to plan files.
+*/
+class PlanArchiveWriter : public PlanSink {
+  std::string filename;
+  FILE *file;
+  int compression_level; // 0: no compression
+  bool wrote_operators;
+  Plan previous_plan;
+  std::string buffer; // Uncompressed body of the current plan
+#ifdef USE_ZLIB
+  z_stream stream;
+#endif
+
+  void write_operators(const TaskProxy &task_proxy);
+  void write_varint(size_t value);
+  void write_raw(const void *data, size_t size);
+  void flush_buffer();
+
+public:
+  static const int VERSION = 1;
+  static bool supports_compression();
+
+  PlanArchiveWriter(const std::string &filename, int compression_level);
+  virtual ~PlanArchiveWriter() override;
+
+  virtual void save_plan(const Plan &plan,
+                         const TaskProxy &task_proxy) override;
+};
+
+#endif
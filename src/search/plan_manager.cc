@@ -38,6 +38,10 @@ void PlanManager::set_is_part_of_anytime_portfolio(
   is_part_of_anytime_portfolio = is_part_of_anytime_portfolio_;
 }
 
+void PlanManager::set_plan_sink(const shared_ptr<PlanSink> &plan_sink_) {
+  plan_sink = plan_sink_;
+}
+
 void PlanManager::dump_plan(const Plan &plan,
                             const TaskProxy &task_proxy) const {
   OperatorsProxy operators = task_proxy.get_operators();
@@ -53,6 +57,20 @@ void PlanManager::dump_plan(const Plan &plan,
 void PlanManager::save_plan(const Plan &plan, const TaskProxy &task_proxy,
                             bool dump_plan,
                             bool generates_multiple_plan_files) {
+  // The sink only replaces the plan file, not the output of the plan
+  if (plan_sink) {
+    plan_sink->save_plan(plan, task_proxy);
+  } else {
+    write_plan_file(plan, task_proxy, generates_multiple_plan_files);
+  }
+  if (dump_plan) {
+    this->dump_plan(plan, task_proxy);
+  }
+  ++num_previously_generated_plans;
+}
+
+void PlanManager::write_plan_file(const Plan &plan, const TaskProxy &task_proxy,
+                                  bool generates_multiple_plan_files) {
   ostringstream filename;
   filename << plan_filename;
   int plan_number = num_previously_generated_plans + 1;
@@ -68,10 +86,6 @@ void PlanManager::save_plan(const Plan &plan, const TaskProxy &task_proxy,
   }
   OperatorsProxy operators = task_proxy.get_operators();
   for (OperatorID op_id : plan) {
-    if (dump_plan) {
-      cout << operators[op_id].get_name() << " (" << operators[op_id].get_cost()
-           << ")" << endl;
-    }
     outfile << "(" << operators[op_id].get_name() << ")" << endl;
   }
   int plan_cost = calculate_plan_cost(plan, task_proxy);
@@ -79,9 +93,4 @@ void PlanManager::save_plan(const Plan &plan, const TaskProxy &task_proxy,
   outfile << "; cost = " << plan_cost << " ("
           << (is_unit_cost ? "unit cost" : "general cost") << ")" << endl;
   outfile.close();
-  if (dump_plan) {
-    cout << "Plan length: " << plan.size() << " step(s)." << endl;
-    cout << "Plan cost: " << plan_cost << endl;
-  }
-  ++num_previously_generated_plans;
 }
@@ -1,6 +1,7 @@
 #ifndef PLAN_MANAGER_H
 #define PLAN_MANAGER_H
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -9,10 +10,25 @@ class TaskProxy;
 
 using Plan = std::vector<OperatorID>;
 
+/*
+  Destination of the plans saved by a PlanManager. Without a sink, each plan
+  is written to its own text file.
+*/
+class PlanSink {
+public:
+  virtual ~PlanSink() = default;
+  virtual void save_plan(const Plan &plan, const TaskProxy &task_proxy) = 0;
+};
+
 class PlanManager {
   std::string plan_filename;
   int num_previously_generated_plans;
   bool is_part_of_anytime_portfolio;
+  // Shared by all copies of the plan manager
+  std::shared_ptr<PlanSink> plan_sink;
+
+  void write_plan_file(const Plan &plan, const TaskProxy &task_proxy,
+                       bool generates_multiple_plan_files);
 
 public:
   PlanManager();
@@ -21,6 +37,7 @@ public:
   std::string get_plan_filename() const { return plan_filename; } 
   void set_num_previously_generated_plans(int num_previously_generated_plans);
   void set_is_part_of_anytime_portfolio(bool is_part_of_anytime_portfolio);
+  void set_plan_sink(const std::shared_ptr<PlanSink> &plan_sink);
   int get_num_previously_generated_plans() const {
     return num_previously_generated_plans;
   }
@@ -3,18 +3,177 @@
 #include "search_engine.h"
 
 #include "options/registries.h"
+#include "tasks/binary_root_task.h"
 #include "tasks/root_task.h"
 #include "task_utils/task_properties.h"
 #include "utils/system.h"
 #include "utils/timer.h"
 
+#include <cctype>
 #include <iostream>
 #include <chrono>
+#include <fstream>
+#include <sstream>
 #include <sys/resource.h>
+#include <vector>
 
 using namespace std;
 using utils::ExitCode;
 
+// Returns the argument after option or an empty string if not given.
+static string get_file_arg(int argc, const char **argv, const string &option) {
+    for (int i = 1; i < argc - 1; ++i) {
+        if (argv[i] == option) {
+            return argv[i + 1];
+        }
+    }
+    return "";
+}
+
+// Returns nullptr (after printing the error) if the arguments are invalid.
+static shared_ptr<SearchEngine> parse_engine(
+    int argc, const char **argv, bool unit_cost) {
+    try {
+        options::Registry registry(*options::RawRegistry::instance());
+        parse_cmd_line(argc, argv, registry, true, unit_cost);
+        return parse_cmd_line(argc, argv, registry, false, unit_cost);
+    } catch (const ArgError &error) {
+        error.print();
+        usage(argv[0]);
+    } catch (const OptionParserError &error) {
+        error.print();
+        usage(argv[0]);
+    } catch (const ParseError &error) {
+        error.print();
+    }
+    return nullptr;
+}
+
+static ExitCode run_engine(SearchEngine &engine) {
+    std::chrono::steady_clock::time_point wall_begin = std::chrono::steady_clock::now();
+    utils::Timer search_timer;
+    engine.search();
+    search_timer.stop();
+    std::chrono::steady_clock::time_point wall_end = std::chrono::steady_clock::now();
+    utils::g_timer.stop();
+
+    // engine.save_plan_if_necessary();
+    engine.print_statistics();
+    cout << "Search time: " << search_timer << endl;
+    cout << "Search-Wall time: " << std::chrono::duration_cast<std::chrono::microseconds>(wall_end - wall_begin).count() / 1000000.0 << "s" << endl;
+    cout << "Total time: " << utils::g_timer << endl;
+
+    if (engine.get_status() == TIMEOUT && utils::is_cancellation_requested()) {
+        return engine.found_solution() ?
+               ExitCode::SEARCH_PLAN_FOUND_AND_OUT_OF_TIME :
+               ExitCode::SEARCH_OUT_OF_TIME;
+    } else if (engine.found_solution()) {
+        return ExitCode::SUCCESS;
+    } else {
+        return ExitCode::SEARCH_UNSOLVED_INCOMPLETE;
+    }
+}
+
+// Splits a request at whitespace, except within single or double quotes.
+static vector<string> split_request(const string &line) {
+    vector<string> words;
+    string word;
+    bool in_word = false;
+    char quote = 0;
+    for (char c : line) {
+        if (quote) {
+            if (c == quote) {
+                quote = 0;
+            } else {
+                word += c;
+            }
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+            in_word = true;
+        } else if (isspace(static_cast<unsigned char>(c))) {
+            if (in_word) {
+                words.push_back(word);
+                word.clear();
+                in_word = false;
+            }
+        } else {
+            word += c;
+            in_word = true;
+        }
+    }
+    if (in_word) {
+        words.push_back(word);
+    }
+    return words;
+}
+
+static ExitCode run_request(const vector<string> &request, string &loaded_task) {
+    ifstream task_file(request[0]);
+    if (!task_file) {
+        cerr << "Could not read task " << request[0] << endl;
+        return ExitCode::SEARCH_INPUT_ERROR;
+    }
+    stringstream task;
+    task << task_file.rdbuf();
+    if (task.str() != loaded_task) {
+        // Symbolic searches drop what they cached for the previous task
+        // (see symbolic/sym_state_space_cache.h)
+        tasks::g_root_task = nullptr;
+        tasks::read_root_task(task);
+        loaded_task = task.str();
+        cout << "done reading input! [t=" << utils::g_timer << "]" << endl;
+    } else {
+        cout << "Reusing the task of the previous request" << endl;
+    }
+    bool unit_cost = task_properties::is_unit_cost(TaskProxy(*tasks::g_root_task));
+
+    vector<const char *> argv = {"downward"};
+    for (size_t i = 1; i < request.size(); ++i) {
+        argv.push_back(request[i].c_str());
+    }
+    shared_ptr<SearchEngine> engine = parse_engine(argv.size(), argv.data(), unit_cost);
+    if (!engine) {
+        return ExitCode::SEARCH_INPUT_ERROR;
+    }
+    return run_engine(*engine);
+}
+
+/*
+  Planner service: each line of the standard input is a request with a task
+  file followed by the usual arguments, e.g.,
+    output.sas --search "sym-fw()" --internal-plan-file plans/1
+  The task is only read again if the file has changed, and symbolic searches
+  reuse the BDDs of previous requests on the same task. The result of each
+  request is reported in one line of the standard output. The service stops
+  at the end of the input or after a request that was cancelled by a signal.
+*/
+static ExitCode run_service() {
+    string loaded_task;
+    string line;
+    int num_requests = 0;
+    while (getline(cin, line)) {
+        vector<string> request = split_request(line);
+        if (request.empty() || request[0][0] == '#') {
+            continue;
+        }
+        ++num_requests;
+        utils::g_timer.reset();
+        utils::g_timer.resume();
+        cout << "Request " << num_requests << ": " << line << endl;
+        ExitCode exitcode = run_request(request, loaded_task);
+        const char *message = utils::get_exit_code_message_reentrant(exitcode);
+        cout << "Request " << num_requests << " finished: "
+             << (message ? message : "Unknown exitcode.") << " [exit code "
+             << static_cast<int>(exitcode) << ", t=" << utils::g_timer << "]"
+             << endl;
+        if (utils::is_cancellation_requested()) {
+            return exitcode;
+        }
+    }
+    cout << "Service finished after " << num_requests << " requests" << endl;
+    return ExitCode::SUCCESS;
+}
+
 int main(int argc, const char **argv) {
     utils::register_event_handlers();
 
@@ -23,11 +182,25 @@ int main(int argc, const char **argv) {
         utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
     }
 
+    bool service = static_cast<string> (argv[1]) == "--service";
     bool unit_cost = false;
-    if (static_cast<string> (argv[1]) != "--help") {
+    if (static_cast<string> (argv[1]) != "--help" && !service) {
+        string binary_task = get_file_arg(argc, argv, "--binary-task");
         cout << "reading input... [t=" << utils::g_timer << "]" << endl;
-        tasks::read_root_task(cin);
+        if (binary_task.empty()) {
+            tasks::read_root_task(cin);
+        } else {
+            tasks::read_binary_root_task(binary_task);
+        }
         cout << "done reading input! [t=" << utils::g_timer << "]" << endl;
+
+        string write_binary_task =
+            get_file_arg(argc, argv, "--write-binary-task");
+        if (!write_binary_task.empty()) {
+            tasks::write_binary_task(*tasks::g_root_task, write_binary_task);
+            cout << "Binary task written to " << write_binary_task << endl;
+            utils::exit_with(ExitCode::SUCCESS);
+        }
         TaskProxy task_proxy(*tasks::g_root_task);
         unit_cost = task_properties::is_unit_cost(task_proxy);
     }
@@ -50,43 +223,14 @@ int main(int argc, const char **argv) {
         }
     }
 
-    shared_ptr<SearchEngine> engine;
-
-    // The command line is parsed twice: once in dry-run mode, to
-    // check for simple input errors, and then in normal mode.
-    try {
-        options::Registry registry(*options::RawRegistry::instance());
-        parse_cmd_line(argc, argv, registry, true, unit_cost);
-        engine = parse_cmd_line(argc, argv, registry, false, unit_cost);
-    }    catch (const ArgError &error) {
-        error.print();
-        usage(argv[0]);
-        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
-    }    catch (const OptionParserError &error) {
-        error.print();
-        usage(argv[0]);
-        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
-    }    catch (const ParseError &error) {
-        error.print();
-        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    if (service) {
+        tasks::g_root_task_reused = true;
+        utils::exit_with(run_service());
     }
 
-    std::chrono::steady_clock::time_point wall_begin = std::chrono::steady_clock::now();
-    utils::Timer search_timer;
-    engine->search();
-    search_timer.stop();
-    std::chrono::steady_clock::time_point wall_end = std::chrono::steady_clock::now();
-    utils::g_timer.stop();
-
-    // engine->save_plan_if_necessary();
-    engine->print_statistics();
-    cout << "Search time: " << search_timer << endl;
-    cout << "Search-Wall time: " << std::chrono::duration_cast<std::chrono::microseconds>(wall_end - wall_begin).count() / 1000000.0 << "s" << endl;
-    cout << "Total time: " << utils::g_timer << endl;
-
-    if (engine->found_solution()) {
-        utils::exit_with(ExitCode::SUCCESS);
-    } else {
-        utils::exit_with(ExitCode::SEARCH_UNSOLVED_INCOMPLETE);
+    shared_ptr<SearchEngine> engine = parse_engine(argc, argv, unit_cost);
+    if (!engine) {
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
     }
+    utils::exit_with(run_engine(*engine));
 }
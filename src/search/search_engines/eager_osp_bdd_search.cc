@@ -0,0 +1,155 @@
+#include "eager_osp_bdd_search.h"
+
+#include "../axioms.h"
+#include "../option_parser.h"
+
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace eager_search {
+// The closed list needs few nodes compared to symbolic search, and a small
+// manager collects the garbage of the insertions more often
+static const long CUDD_INIT_NODES = 1000000L;
+static const long CUDD_INIT_CACHE_SIZE = 1000000L;
+
+EagerOspBddSearch::EagerOspBddSearch(const Options &opts)
+    : SearchEngine(opts), axiom_evaluator(g_axiom_evaluators[task_proxy]),
+      vars(true, CUDD_INIT_NODES, CUDD_INIT_CACHE_SIZE),
+      batch_size(opts.get<int>("batch_size")), max_utility(0), best_g(0),
+      best_depth(0), best_utility(numeric_limits<int>::min()) {}
+
+void EagerOspBddSearch::initialize() {
+  vars.init();
+  closed = unique_ptr<symbolic::ExplicitClosedList>(
+      new symbolic::ExplicitClosedList(&vars, task_proxy, batch_size));
+  bound = task->get_plan_bound();
+
+  // Each variable contributes the best utility of its values (or 0)
+  VariablesProxy variables = task_proxy.get_variables();
+  fact_utilities.resize(variables.size());
+  for (VariableProxy var : variables) {
+    fact_utilities[var.get_id()].assign(var.get_domain_size(), 0);
+  }
+  for (auto &pair : task->get_utilities()) {
+    fact_utilities[pair.first.var][pair.first.value] = pair.second;
+  }
+  for (const vector<int> &utilities : fact_utilities) {
+    max_utility += *max_element(utilities.begin(), utilities.end());
+  }
+
+  cout << "Conducting OSP search by increasing g with a BDD closed list, "
+       << "(real) bound = " << bound << ", batch size = " << batch_size
+       << endl;
+
+  unique_ptr<StateRegistry> initial_layer(new StateRegistry(task_proxy));
+  initial_layer->get_initial_state();
+  open[make_pair(0, 0)] = move(initial_layer);
+}
+
+int EagerOspBddSearch::get_utility(const vector<int> &state) const {
+  int utility = 0;
+  for (size_t var = 0; var < state.size(); ++var) {
+    utility += fact_utilities[var][state[var]];
+  }
+  return utility;
+}
+
+SearchStatus EagerOspBddSearch::step() {
+  // The states of a layer are expanded in the order they were registered,
+  // and the layer is released once all of them have been expanded
+  if (next_open && *next_open == open.begin()->second->end()) {
+    next_open = nullptr;
+    open.erase(open.begin());
+  }
+  if (open.empty()) {
+    return extract_best_plan();
+  }
+  int g = open.begin()->first.first;
+  int depth = open.begin()->first.second;
+  StateRegistry &layer = *open.begin()->second;
+  if (!next_open) {
+    next_open = unique_ptr<StateRegistry::const_iterator>(
+        new StateRegistry::const_iterator(layer.begin()));
+  }
+  GlobalState state = layer.lookup_state(**next_open);
+  ++*next_open;
+
+  State unpacked_state = state.unpack();
+  const vector<int> &values = unpacked_state.get_values();
+  if (closed->contains(values)) {
+    return IN_PROGRESS;
+  }
+  closed->insert(g, depth, values);
+  statistics.inc_expanded();
+
+  if (task_properties::is_goal_state(task_proxy, state)) {
+    int utility = get_utility(values);
+    if (utility > best_utility) {
+      best_state = values;
+      best_g = g;
+      best_depth = depth;
+      best_utility = utility;
+      cout << "[INFO] Best utility: " << best_utility << " [g=" << g << ", "
+           << statistics.get_expanded() << " expanded]" << endl;
+      if (best_utility == max_utility) {
+        return extract_best_plan();
+      }
+    }
+  }
+
+  vector<OperatorID> applicable_ops;
+  successor_generator.generate_applicable_ops(state, applicable_ops);
+  for (OperatorID op_id : applicable_ops) {
+    OperatorProxy op = task_proxy.get_operators()[op_id];
+    int succ_g = g + op.get_cost();
+    if (succ_g >= bound) {
+      continue;
+    }
+    statistics.inc_generated();
+
+    // Successors that are closed already are not registered
+    vector<int> succ_values = values;
+    for (EffectProxy effect : op.get_effects()) {
+      if (does_fire(effect, unpacked_state)) {
+        FactPair effect_pair = effect.get_fact().get_pair();
+        succ_values[effect_pair.var] = effect_pair.value;
+      }
+    }
+    axiom_evaluator.evaluate(succ_values);
+    if (closed->contains(succ_values)) {
+      continue;
+    }
+
+    int succ_depth = op.get_cost() == 0 ? depth + 1 : 0;
+    unique_ptr<StateRegistry> &succ_layer =
+        open[make_pair(succ_g, succ_depth)];
+    if (!succ_layer) {
+      succ_layer = unique_ptr<StateRegistry>(new StateRegistry(task_proxy));
+    }
+    succ_layer->get_successor_state(state, op);
+  }
+  return IN_PROGRESS;
+}
+
+SearchStatus EagerOspBddSearch::extract_best_plan() {
+  if (best_state.empty()) {
+    cout << "No goal state within the bound -- no solution!" << endl;
+    return FAILED;
+  }
+  set_plan(closed->extract_path(best_g, best_depth, best_state));
+  cout << "Plan utility: " << best_utility << endl;
+  save_plan_if_necessary();
+  return SOLVED;
+}
+
+void EagerOspBddSearch::print_statistics() const {
+  statistics.print_detailed_statistics();
+  closed->print_statistics();
+}
+
+} // namespace eager_search
@@ -0,0 +1,63 @@
+#ifndef SEARCH_ENGINES_EAGER_OSP_BDD_SEARCH_H
+#define SEARCH_ENGINES_EAGER_OSP_BDD_SEARCH_H
+
+#include "../search_engine.h"
+#include "../symbolic/explicit_closed_list.h"
+#include "../symbolic/sym_variables.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+class AxiomEvaluator;
+
+namespace options {
+class Options;
+}
+
+namespace eager_search {
+/*
+ * Explicit OSP search that expands states by increasing g (and zero-cost
+ * depth) without keeping them registered: the open states of each layer are
+ * registered in a registry of their own that is released once the layer has
+ * been expanded, closed states are kept in a BDD-based closed list and the
+ * plan to the best state is extracted from it symbolically.
+ */
+class EagerOspBddSearch : public SearchEngine {
+  AxiomEvaluator &axiom_evaluator;
+
+  symbolic::SymVariables vars;
+  std::unique_ptr<symbolic::ExplicitClosedList> closed;
+  int batch_size;
+
+  // Open states by g and zero-cost depth. The layer that is being expanded
+  // does not grow, since successors have a higher g or depth.
+  std::map<std::pair<int, int>, std::unique_ptr<StateRegistry>> open;
+  // Next state of the first layer to expand
+  std::unique_ptr<StateRegistry::const_iterator> next_open;
+
+  // Utility of each fact, and an upper bound of the utility of any state
+  std::vector<std::vector<int>> fact_utilities;
+  int max_utility;
+
+  std::vector<int> best_state;
+  int best_g;
+  int best_depth;
+  int best_utility;
+
+  int get_utility(const std::vector<int> &state) const;
+  SearchStatus extract_best_plan();
+
+protected:
+  virtual void initialize() override;
+  virtual SearchStatus step() override;
+
+public:
+  explicit EagerOspBddSearch(const options::Options &opts);
+  virtual ~EagerOspBddSearch() = default;
+
+  virtual void print_statistics() const override;
+};
+} // namespace eager_search
+
+#endif
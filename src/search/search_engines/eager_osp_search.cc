@@ -8,6 +8,7 @@
 
 #include "../algorithms/ordered_set.h"
 #include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
 
 #include <cassert>
 #include <cstdlib>
@@ -36,7 +37,11 @@ void EagerOspSearch::initialize() {
 SearchStatus EagerOspSearch::step() {
   pair<SearchNode, bool> n = fetch_next_node();
   if (!n.second) {
-    check_goal_and_set_plan(best_state);
+    if (!check_goal_and_set_plan(best_state)) {
+      std::cout << "No goal state within the bound -- no solution!"
+                << std::endl;
+      return FAILED;
+    }
     std::cout << "Plan utility: " << best_utility << std::endl;
     save_plan_if_necessary();
     return SOLVED;
@@ -45,21 +50,25 @@ SearchStatus EagerOspSearch::step() {
 
   GlobalState s = node.get_state();
 
-  BDD bdd_state = vars.getStateBDD(s);
-  ADD add_state_util = add_utility_function * bdd_state.Add();
-  double state_util = Cudd_V(add_state_util.FindMax().getNode());
-  if (std::abs(max_utility - state_util) < 0.001) {
-    best_state = s;
-    best_utility = state_util;
-    check_goal_and_set_plan(best_state);
-    std::cout << "Plan utility: " << best_utility << std::endl;
-    save_plan_if_necessary();
-    return SOLVED;
-  }
+  // Only goal states are solutions (OSP tasks usually have no hard goals,
+  // i.e., all states are goal states)
+  if (task_properties::is_goal_state(task_proxy, s)) {
+    BDD bdd_state = vars.getStateBDD(s);
+    ADD add_state_util = add_utility_function * bdd_state.Add();
+    double state_util = Cudd_V(add_state_util.FindMax().getNode());
+    if (std::abs(max_utility - state_util) < 0.001) {
+      best_state = s;
+      best_utility = state_util;
+      check_goal_and_set_plan(best_state);
+      std::cout << "Plan utility: " << best_utility << std::endl;
+      save_plan_if_necessary();
+      return SOLVED;
+    }
 
-  if (state_util > best_utility) {
-    best_state = s;
-    best_utility = state_util;
+    if (state_util > best_utility) {
+      best_state = s;
+      best_utility = state_util;
+    }
   }
 
   vector<OperatorID> applicable_ops;
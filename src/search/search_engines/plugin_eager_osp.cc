@@ -1,3 +1,4 @@
+#include "eager_osp_bdd_search.h"
 #include "eager_osp_search.h"
 #include "search_common.h"
 
@@ -33,5 +34,28 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
   return engine;
 }
 
+static shared_ptr<SearchEngine> _parse_bdd(OptionParser &parser) {
+  parser.document_synopsis(
+      "Eager OSP search with a BDD closed list",
+      "Expands states by increasing g without registering them. Closed "
+      "states are stored as BDDs and the plan is extracted from them.");
+
+  parser.add_option<int>("batch_size",
+                         "number of closed states inserted at once into the "
+                         "BDDs of the closed list",
+                         "1000", Bounds("1", "infinity"));
+
+  SearchEngine::add_options_to_parser(parser);
+  Options opts = parser.parse();
+
+  shared_ptr<eager_search::EagerOspBddSearch> engine;
+  if (!parser.dry_run()) {
+    engine = make_shared<eager_search::EagerOspBddSearch>(opts);
+  }
+
+  return engine;
+}
+
 static Plugin<SearchEngine> _plugin("eager_osp", _parse);
+static Plugin<SearchEngine> _plugin_bdd("eager_osp_bdd", _parse_bdd);
 } // namespace plugin_eager_osp
@@ -0,0 +1,80 @@
+# Runs sym-benchmark on all tasks of CORPUS: SAS files are used directly
+# and each X-problem.pddl (with X-domain.pddl) is translated first. The
+# results are compared with the baseline of each task in BASELINE_DIR. A
+# missing baseline is an error, unless WRITE_BASELINES is set, in which
+# case the baselines are (re)written instead of compared.
+#
+# Variables: BENCHMARK, TRANSLATOR, CORPUS, BASELINE_DIR, WORK_DIR and
+# optionally BENCHMARK_ARGS (e.g. "--max-slowdown 2") and WRITE_BASELINES.
+
+separate_arguments(BENCHMARK_ARGS)
+find_program(PYTHON NAMES python3 python)
+file(MAKE_DIRECTORY ${WORK_DIR})
+if(WRITE_BASELINES)
+    file(MAKE_DIRECTORY ${BASELINE_DIR})
+endif()
+
+file(GLOB SAS_TASKS ${CORPUS}/*.sas)
+file(GLOB PDDL_PROBLEMS ${CORPUS}/*-problem.pddl)
+foreach(PROBLEM ${PDDL_PROBLEMS})
+    get_filename_component(NAME ${PROBLEM} NAME)
+    string(REPLACE "-problem.pddl" "" NAME ${NAME})
+    set(DOMAIN ${CORPUS}/${NAME}-domain.pddl)
+    set(SAS_TASK ${WORK_DIR}/${NAME}.sas)
+    if(EXISTS ${DOMAIN} AND NOT EXISTS ${SAS_TASK})
+        # The translator always writes output.sas
+        file(REMOVE ${WORK_DIR}/output.sas)
+        execute_process(
+            COMMAND ${PYTHON} ${TRANSLATOR} ${DOMAIN} ${PROBLEM}
+            WORKING_DIRECTORY ${WORK_DIR}
+            OUTPUT_QUIET
+            RESULT_VARIABLE RESULT)
+        if(RESULT EQUAL 0 AND EXISTS ${WORK_DIR}/output.sas)
+            file(RENAME ${WORK_DIR}/output.sas ${SAS_TASK})
+        else()
+            message(WARNING "Could not translate ${PROBLEM}")
+        endif()
+    endif()
+    if(EXISTS ${SAS_TASK})
+        list(APPEND SAS_TASKS ${SAS_TASK})
+    endif()
+endforeach()
+
+if(NOT SAS_TASKS)
+    message(FATAL_ERROR "No benchmark tasks in ${CORPUS}")
+endif()
+
+set(FAILED 0)
+foreach(SAS_TASK ${SAS_TASKS})
+    get_filename_component(NAME ${SAS_TASK} NAME_WE)
+    set(BASELINE ${BASELINE_DIR}/${NAME}.txt)
+    if(WRITE_BASELINES)
+        set(BASELINE_ARGS --write-baseline ${BASELINE})
+    elseif(EXISTS ${BASELINE})
+        set(BASELINE_ARGS --baseline ${BASELINE})
+    else()
+        # The results are still reported, but the test fails
+        message(STATUS "Missing baseline ${BASELINE} of ${NAME} (write it "
+                       "with SYMBOLIC_BENCHMARK_WRITE_BASELINES)")
+        set(BASELINE_ARGS "")
+        set(FAILED 1)
+    endif()
+    message(STATUS "Benchmark ${NAME}")
+    execute_process(
+        COMMAND ${BENCHMARK} ${BENCHMARK_ARGS} ${BASELINE_ARGS} ${SAS_TASK}
+        OUTPUT_VARIABLE OUTPUT
+        ERROR_VARIABLE OUTPUT
+        RESULT_VARIABLE RESULT)
+    string(REGEX MATCHALL "Benchmark [^\n]*" LINES "${OUTPUT}")
+    foreach(LINE ${LINES})
+        message(STATUS "  ${LINE}")
+    endforeach()
+    if(NOT RESULT EQUAL 0)
+        message(STATUS "${OUTPUT}")
+        set(FAILED 1)
+    endif()
+endforeach()
+
+if(FAILED)
+    message(FATAL_ERROR "Benchmarks failed")
+endif()
@@ -0,0 +1,340 @@
+/*
+ * Microbenchmarks of the symbolic kernels (images, merges, mutex filtering,
+ * solution cuts and OSP utilities) on a single SAS task.
+ *
+ * Usage: sym-benchmark [options] <task.sas>
+ *   --repetitions N      timed repetitions of each kernel (default 10)
+ *   --warmup N           untimed repetitions of each kernel (default 2)
+ *   --layers N           forward layers used as workload (default 10)
+ *   --baseline FILE      compare the results with FILE
+ *   --write-baseline FILE
+ *                        write the results to FILE
+ *   --max-slowdown X     fail if a kernel is X times slower than the
+ *                        baseline (default 0, i.e., only report)
+ *
+ * Baseline files have one line per kernel: name ns/op nodes memory-kB,
+ * where the memory is the growth of the memory in use by CUDD during the
+ * (warm-up and timed) repetitions of the kernel.
+ */
+
+#include "../closed_list.h"
+#include "../original_state_space.h"
+#include "../plan_reconstruction/sym_solution_cut.h"
+#include "../sym_state_space_manager.h"
+#include "../sym_utils.h"
+#include "../sym_variables.h"
+#include "../transition_relation.h"
+
+#include "../../tasks/root_task.h"
+#include "../../utils/system.h"
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace symbolic;
+using utils::ExitCode;
+
+namespace {
+struct BenchmarkOptions {
+  int repetitions = 10;
+  int warmup = 2;
+  int layers = 10;
+  string baseline;
+  string write_baseline;
+  double max_slowdown = 0;
+  string task;
+};
+
+// Work done by one call of a kernel
+struct KernelRun {
+  int ops;
+  long nodes; // Nodes of the result
+};
+
+struct KernelResult {
+  string name;
+  double ns_per_op;
+  long nodes;
+  long memory_kb; // Growth of the memory in use by CUDD
+};
+
+void usage(const char *program) {
+  cerr << "Usage: " << program
+       << " [--repetitions N] [--warmup N] [--layers N] [--baseline FILE]"
+          " [--write-baseline FILE] [--max-slowdown X] <task.sas>"
+       << endl;
+  utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+}
+
+BenchmarkOptions parse_options(int argc, const char **argv) {
+  BenchmarkOptions opts;
+  for (int i = 1; i < argc; ++i) {
+    string arg = argv[i];
+    if (arg.size() > 2 && arg.substr(0, 2) == "--") {
+      if (i + 1 == argc) {
+        usage(argv[0]);
+      }
+      string value = argv[++i];
+      if (arg == "--repetitions") {
+        opts.repetitions = stoi(value);
+      } else if (arg == "--warmup") {
+        opts.warmup = stoi(value);
+      } else if (arg == "--layers") {
+        opts.layers = stoi(value);
+      } else if (arg == "--baseline") {
+        opts.baseline = value;
+      } else if (arg == "--write-baseline") {
+        opts.write_baseline = value;
+      } else if (arg == "--max-slowdown") {
+        opts.max_slowdown = stod(value);
+      } else {
+        usage(argv[0]);
+      }
+    } else if (opts.task.empty()) {
+      opts.task = arg;
+    } else {
+      usage(argv[0]);
+    }
+  }
+  if (opts.task.empty() || opts.repetitions < 1) {
+    usage(argv[0]);
+  }
+  return opts;
+}
+
+KernelResult run_kernel(const string &name, const BenchmarkOptions &opts,
+                        Cudd &manager, const function<KernelRun()> &kernel) {
+  long memory_before = manager.ReadMemoryInUse();
+  for (int i = 0; i < opts.warmup; ++i) {
+    kernel();
+  }
+  long ops = 0;
+  KernelRun run{0, 0};
+  auto start = chrono::steady_clock::now();
+  for (int i = 0; i < opts.repetitions; ++i) {
+    run = kernel();
+    ops += run.ops;
+  }
+  auto end = chrono::steady_clock::now();
+  double ns = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+  long memory_kb = ((long)manager.ReadMemoryInUse() - memory_before) / 1024;
+  return KernelResult{name, ops > 0 ? ns / ops : ns, run.nodes, memory_kb};
+}
+
+map<string, KernelResult> read_baseline(const string &filename) {
+  map<string, KernelResult> baseline;
+  ifstream file(filename);
+  if (!file) {
+    cerr << "Error: could not open baseline " << filename << endl;
+    utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+  }
+  KernelResult result;
+  while (file >> result.name >> result.ns_per_op >> result.nodes >>
+         result.memory_kb) {
+    baseline[result.name] = result;
+  }
+  return baseline;
+}
+
+void write_baseline(const string &filename,
+                    const vector<KernelResult> &results) {
+  ofstream file(filename);
+  if (!file) {
+    cerr << "Error: could not write baseline " << filename << endl;
+    utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+  }
+  for (const KernelResult &result : results) {
+    file << result.name << " " << result.ns_per_op << " " << result.nodes
+         << " " << result.memory_kb << endl;
+  }
+}
+
+long sum_nodes(const vector<BDD> &bdds) {
+  long nodes = 0;
+  for (const BDD &bdd : bdds) {
+    nodes += bdd.nodeCount();
+  }
+  return nodes;
+}
+} // namespace
+
+int main(int argc, const char **argv) {
+  BenchmarkOptions opts = parse_options(argc, argv);
+
+  ifstream task_file(opts.task);
+  if (!task_file) {
+    cerr << "Error: could not open task " << opts.task << endl;
+    utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+  }
+  tasks::read_root_task(task_file);
+
+  shared_ptr<SymVariables> vars = make_shared<SymVariables>(true);
+  vars->init();
+  SymParamsMgr mgr_params;
+  shared_ptr<OriginalStateSpace> mgr =
+      make_shared<OriginalStateSpace>(vars.get(), mgr_params);
+  const int max_nodes = numeric_limits<int>::max();
+  Cudd &manager = *vars->get_manager();
+
+  vector<const TransitionRelation *> trs;
+  for (const auto &cost_trs : mgr->getTransitions()) {
+    for (const TransitionRelation &tr : cost_trs.second) {
+      trs.push_back(&tr);
+    }
+  }
+
+  // Workload: forward layers from the initial state (ignoring costs)
+  vector<BDD> layers{mgr->getInitialState()};
+  BDD reached = layers.back();
+  while ((int)layers.size() < opts.layers) {
+    BDD next = vars->zeroBDD();
+    for (const TransitionRelation *tr : trs) {
+      next += tr->image(layers.back());
+    }
+    next *= !reached;
+    if (next.IsZero()) {
+      break;
+    }
+    reached += next;
+    layers.push_back(next);
+  }
+  const BDD &frontier = layers.back();
+  BDD goal = mgr->getGoal();
+  cout << "Benchmark workload: " << trs.size() << " TRs, " << layers.size()
+       << " layers, frontier nodes: " << frontier.nodeCount()
+       << ", reached nodes: " << reached.nodeCount() << endl;
+
+  ClosedList closed;
+  closed.init(mgr.get());
+  closed.enable_cumulative_sets();
+  for (size_t g = 0; g < layers.size(); ++g) {
+    closed.insert(g, layers[g]);
+  }
+
+  vector<KernelResult> results;
+  results.push_back(run_kernel("image", opts, manager, [&]() {
+    vector<BDD> res;
+    for (const TransitionRelation *tr : trs) {
+      res.push_back(tr->image(frontier));
+    }
+    return KernelRun{(int)trs.size(), sum_nodes(res)};
+  }));
+  results.push_back(run_kernel("preimage", opts, manager, [&]() {
+    vector<BDD> res;
+    for (const TransitionRelation *tr : trs) {
+      res.push_back(tr->preimage(goal));
+    }
+    return KernelRun{(int)trs.size(), sum_nodes(res)};
+  }));
+
+  Bucket images;
+  for (const TransitionRelation *tr : trs) {
+    images.push_back(tr->image(frontier));
+  }
+  results.push_back(run_kernel("merge", opts, manager, [&]() {
+    Bucket bucket(images);
+    mgr->mergeBucket(bucket, mgr_params.max_aux_time, max_nodes);
+    return KernelRun{1, sum_nodes(bucket)};
+  }));
+
+  BDD successors = vars->zeroBDD();
+  for (const BDD &img : images) {
+    successors += img;
+  }
+  results.push_back(run_kernel("filter_mutex_fw", opts, manager, [&]() {
+    BDD res = mgr->filter_mutex(successors, true, max_nodes, false);
+    return KernelRun{1, res.nodeCount()};
+  }));
+  BDD predecessors = vars->zeroBDD();
+  for (const TransitionRelation *tr : trs) {
+    predecessors += tr->preimage(goal);
+  }
+  results.push_back(run_kernel("filter_mutex_bw", opts, manager, [&]() {
+    BDD res = mgr->filter_mutex(predecessors, false, max_nodes, false);
+    return KernelRun{1, res.nodeCount()};
+  }));
+
+  // Cut checks report the time per closed layer. The frontier is in the
+  // last closed layer, which is the worst case of a linear scan.
+  const int num_layers = layers.size();
+  results.push_back(run_kernel("cheapest_cut", opts, manager, [&]() {
+    SymSolutionCut cut = closed.getCheapestCut(frontier, 0, true);
+    return KernelRun{num_layers, cut.get_cut().nodeCount()};
+  }));
+  results.push_back(run_kernel("all_cuts", opts, manager, [&]() {
+    vector<SymSolutionCut> cuts = closed.getAllCuts(reached, 0, true, 0);
+    vector<BDD> res;
+    for (const SymSolutionCut &cut : cuts) {
+      res.push_back(cut.get_cut());
+    }
+    return KernelRun{num_layers, sum_nodes(res)};
+  }));
+  // Only the second half of the layers is in the window of the bounds
+  results.push_back(run_kernel("all_cuts_window", opts, manager, [&]() {
+    vector<SymSolutionCut> cuts =
+        closed.getAllCuts(reached, 0, true, num_layers / 2, num_layers);
+    vector<BDD> res;
+    for (const SymSolutionCut &cut : cuts) {
+      res.push_back(cut.get_cut());
+    }
+    return KernelRun{num_layers, sum_nodes(res)};
+  }));
+
+  // Utility function as in the OSP search (only for OSP tasks)
+  if (!tasks::g_root_task->get_utilities().empty()) {
+    ADD utility = vars->zeroBDD().Add();
+    for (auto &pair : tasks::g_root_task->get_utilities()) {
+      BDD fact = vars->get_axiom_compiliation()->get_primary_representation(
+          pair.first.var, pair.first.value);
+      utility += fact.Add() * vars->get_manager()->constant(pair.second);
+    }
+    results.push_back(run_kernel("osp_utility", opts, manager, [&]() {
+      ADD states_utilities = reached.Add() * utility;
+      double max_value = Cudd_V(states_utilities.FindMax().getNode());
+      BDD max_states = states_utilities.BddThreshold(max_value);
+      return KernelRun{1, max_states.nodeCount()};
+    }));
+  }
+
+  map<string, KernelResult> baseline;
+  if (!opts.baseline.empty()) {
+    baseline = read_baseline(opts.baseline);
+  }
+  int regressions = 0;
+  cout << fixed << setprecision(1);
+  for (const KernelResult &result : results) {
+    cout << "Benchmark " << result.name << ": " << result.ns_per_op
+         << " ns/op, nodes: " << result.nodes
+         << ", CUDD memory: " << result.memory_kb << " KB";
+    auto it = baseline.find(result.name);
+    if (it != baseline.end() && it->second.ns_per_op > 0) {
+      double ratio = result.ns_per_op / it->second.ns_per_op;
+      cout << setprecision(2) << " (baseline: " << it->second.ns_per_op
+           << " ns/op, ratio: " << ratio << ")" << setprecision(1);
+      if (it->second.nodes != result.nodes) {
+        cout << " [nodes differ: " << it->second.nodes << "]";
+      }
+      if (opts.max_slowdown > 0 && ratio > opts.max_slowdown) {
+        cout << " [REGRESSION]";
+        ++regressions;
+      }
+    }
+    cout << endl;
+  }
+  cout << defaultfloat;
+  cout << "Peak memory: " << utils::get_peak_memory_in_kb() << " KB" << endl;
+
+  if (!opts.write_baseline.empty()) {
+    write_baseline(opts.write_baseline, results);
+  }
+  utils::exit_with(regressions > 0 ? ExitCode::SEARCH_CRITICAL_ERROR
+                                   : ExitCode::SUCCESS);
+}
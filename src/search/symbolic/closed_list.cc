@@ -3,7 +3,10 @@
 #include "plan_reconstruction/sym_solution_registry.h"
 #include "sym_state_space_manager.h"
 #include "sym_utils.h"
+#include "../utils/system.h"
+#include "../utils/timer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <iostream>
@@ -14,99 +17,455 @@ using namespace std;
 
 namespace symbolic {
 
-ClosedList::ClosedList() : mgr(nullptr) {}
+ClosedList::ClosedList()
+    : mgr(nullptr), delta_layers(false), last_h(0), cumulative_sets(false),
+      relay_interval(0), relay_fw(true), max_cost(0), max_h(0), segment_lo(0),
+      segment_hi(0) {}
 
 void ClosedList::init(SymStateSpaceManager *manager) {
   mgr = manager;
   map<int, vector<BDD>>().swap(zeroCostClosed);
   map<int, BDD>().swap(closed);
+  vector<pair<int, BDD>>().swap(closedUpTo);
   closedTotal = mgr->zeroBDD();
+
+  last_h = 0;
+  max_h = 0;
+  segment_lo = segment_hi = 0;
+  map<int, BDD>().swap(segment_closed);
+  map<int, vector<BDD>>().swap(segment_zero_closed);
+  if (relay_interval > 0) {
+    // The map is empty in tasks without operators
+    const auto &transitions = mgr->getTransitions();
+    max_cost = transitions.empty() ? 1 : max(1, transitions.rbegin()->first);
+  }
+}
+
+void ClosedList::set_relays(int interval, bool forward) {
+  relay_interval = interval;
+  relay_fw = forward;
 }
 
 void ClosedList::init(SymStateSpaceManager *manager, const ClosedList &other) {
   mgr = manager;
   map<int, vector<BDD>>().swap(zeroCostClosed);
   map<int, BDD>().swap(closed);
+  vector<pair<int, BDD>>().swap(closedUpTo);
   closedTotal = mgr->zeroBDD();
+  last_h = 0;
 
   closedTotal = other.closedTotal;
   closed[0] = closedTotal;
+  if (stores_deltas()) {
+    zeroCostClosed[0].push_back(closedTotal);
+  }
+  if (cumulative_sets) {
+    closedUpTo.emplace_back(0, closedTotal);
+  }
+}
+
+void ClosedList::enable_cumulative_sets() {
+  assert(relay_interval == 0);
+  if (cumulative_sets || delta_layers) {
+    // Delta layers are meant to save memory, so cuts scan them instead
+    return;
+  }
+  cumulative_sets = true;
+  if (!mgr) {
+    // Not initialized yet, so nothing has been closed
+    return;
+  }
+  BDD cumulative = mgr->zeroBDD();
+  for (int h : layer_costs(0, numeric_limits<int>::max())) {
+    cumulative += layer_at(h);
+    closedUpTo.emplace_back(h, cumulative);
+  }
 }
 
 void ClosedList::insert(int h, const BDD &S) {
-  if (closed.count(h)) {
-    closed[h] += S;
-  } else {
-    closed[h] = S;
+  if (relay_interval > 0) {
+    assert(h >= max_h);
+    // The states closed so far are those closed up to the last relay below h
+    int relay = ((h - 1) / relay_interval) * relay_interval;
+    if (h > 0 && relay >= max_h &&
+        (closedUpTo.empty() || closedUpTo.back().first < relay)) {
+      closedUpTo.emplace_back(relay, closedTotal);
+    }
+    max_h = h;
+    closedTotal += S;
+    if (!keeps_layer(h)) {
+      return;
+    }
   }
 
-  if (mgr->hasTransitions0()) {
-    zeroCostClosed[h].push_back(S);
+  if (stores_deltas()) {
+    // Only the layer being closed is materialized, to compute the deltas
+    if (h != last_h) {
+      closed.erase(last_h);
+      last_h = h;
+    }
+    if (!closed.count(h)) {
+      closed[h] = layer_at(h);
+    }
+    BDD delta = S * !closed[h];
+    vector<BDD> &sublayers = zeroCostClosed[h];
+    if (!delta.IsZero()) {
+      closed[h] += delta;
+      sublayers.push_back(delta);
+    }
+  } else {
+    if (closed.count(h)) {
+      closed[h] += S;
+    } else {
+      closed[h] = S;
+    }
+
+    if (mgr->hasTransitions0()) {
+      zeroCostClosed[h].push_back(S);
+    }
+  }
+  if (relay_interval > 0) {
+    // closedUpTo only contains the relays
+    return;
   }
   closedTotal += S;
+  if (!cumulative_sets) {
+    return;
+  }
+
+  // Layers are usually closed in increasing h, so only the last cumulative
+  // set needs to be updated
+  auto it = std::lower_bound(
+      closedUpTo.begin(), closedUpTo.end(), h,
+      [](const pair<int, BDD> &entry, int value) { return entry.first < value; });
+  if (it == closedUpTo.end() || it->first != h) {
+    BDD previous = it == closedUpTo.begin() ? mgr->zeroBDD() : (it - 1)->second;
+    it = closedUpTo.emplace(it, h, previous);
+  }
+  for (; it != closedUpTo.end(); ++it) {
+    it->second += S;
+  }
 }
 
-BDD ClosedList::getPartialClosed(int upper_bound) const {
+bool ClosedList::keeps_layer(int h) const {
+  // Distance to the first relay r >= h
+  int relay = ((h + relay_interval - 1) / relay_interval) * relay_interval;
+  return relay - h < max_cost;
+}
+
+bool ClosedList::dropped_layer(int h) const {
+  return relay_interval > 0 && h <= max_h && !keeps_layer(h);
+}
+
+const map<int, vector<BDD>> &ClosedList::zero_layers_with(int h) const {
+  if (!dropped_layer(h)) {
+    return zeroCostClosed;
+  }
+  regenerate_segment(h);
+  return segment_zero_closed;
+}
+
+BDD ClosedList::get_closed_at(int h) const {
+  if (dropped_layer(h)) {
+    regenerate_segment(h);
+    return segment_closed.count(h) ? segment_closed.at(h) : mgr->zeroBDD();
+  }
+  return layer_at(h);
+}
+
+bool ClosedList::stores_deltas() const {
+  return delta_layers && mgr->hasTransitions0();
+}
+
+BDD ClosedList::layer_at(int h) const {
+  auto it = closed.find(h);
+  if (it != closed.end()) {
+    return it->second;
+  }
+  BDD layer = mgr->zeroBDD();
+  if (stores_deltas() && zeroCostClosed.count(h)) {
+    Bucket sublayers = zeroCostClosed.at(h);
+    mgr->mergeBucket(sublayers);
+    for (const BDD &sublayer : sublayers) {
+      layer += sublayer;
+    }
+  }
+  return layer;
+}
+
+vector<int> ClosedList::layer_costs(int min_h, int max_h) const {
+  vector<int> costs;
+  if (stores_deltas()) {
+    for (auto it = zeroCostClosed.lower_bound(min_h);
+         it != zeroCostClosed.end() && it->first <= max_h; ++it) {
+      costs.push_back(it->first);
+    }
+  } else {
+    for (auto it = closed.lower_bound(min_h);
+         it != closed.end() && it->first <= max_h; ++it) {
+      costs.push_back(it->first);
+    }
+  }
+  return costs;
+}
+
+BDD ClosedList::intersection_at(int h, const BDD &states) const {
+  auto it = closed.find(h);
+  if (it != closed.end()) {
+    return it->second * states;
+  }
+  // The sublayers are usually smaller than their disjunction
   BDD res = mgr->zeroBDD();
-  for (const auto &pair : closed) {
-    if (pair.first > upper_bound) {
-      break;
+  if (stores_deltas() && zeroCostClosed.count(h)) {
+    for (const BDD &sublayer : zeroCostClosed.at(h)) {
+      res += sublayer * states;
+    }
+  }
+  return res;
+}
+
+map<int, BDD> ClosedList::getClosedList() const {
+  map<int, BDD> res;
+  for (int h : layer_costs(0, numeric_limits<int>::max())) {
+    res[h] = layer_at(h);
+  }
+  return res;
+}
+
+void ClosedList::getBDDs(Bucket &bdds) const {
+  for (const auto &layer : closed) {
+    bdds.push_back(layer.second);
+  }
+  for (const auto &sublayers : zeroCostClosed) {
+    bdds.insert(bdds.end(), sublayers.second.begin(), sublayers.second.end());
+  }
+}
+
+void ClosedList::print_layer_memory() const {
+  Cudd &manager = *mgr->getVars()->get_manager();
+  for (int h : layer_costs(0, numeric_limits<int>::max())) {
+    Bucket bdds;
+    bool materialized = closed.count(h);
+    if (materialized) {
+      bdds.push_back(closed.at(h));
+    }
+    size_t num_sublayers = 0;
+    if (zeroCostClosed.count(h)) {
+      const vector<BDD> &sublayers = zeroCostClosed.at(h);
+      num_sublayers = sublayers.size();
+      bdds.insert(bdds.end(), sublayers.begin(), sublayers.end());
+    }
+    cout << "Closed layer " << h << ": " << num_sublayers << " sublayers, "
+         << (bdds.empty() ? 0 : manager.SharingSize(bdds)) << " nodes"
+         << (materialized ? "" : " (not materialized)") << endl;
+  }
+}
+
+void ClosedList::regenerate_segment(int h) const {
+  if (segment_lo < h && h <= segment_hi) {
+    return;
+  }
+  // Layer h lies between two passed relays (or above the last one). Layer 0
+  // is always kept, so there is a relay below h.
+  auto upper = std::lower_bound(
+      closedUpTo.begin(), closedUpTo.end(), h,
+      [](const pair<int, BDD> &entry, int value) { return entry.first < value; });
+  assert(upper != closedUpTo.begin());
+  segment_lo = (upper - 1)->first;
+  segment_hi = upper == closedUpTo.end() ? max_h : upper->first;
+  map<int, BDD>().swap(segment_closed);
+  map<int, vector<BDD>>().swap(segment_zero_closed);
+
+  utils::Timer timer;
+  // States closed after the lower relay that have not been regenerated yet
+  BDD remaining = closedTotal * !(upper - 1)->second;
+  map<int, Bucket> open;
+  auto expand = [&](int g, const BDD &states) {
+    map<int, vector<BDD>> images;
+    mgr->cost_image(relay_fw, states, images, numeric_limits<int>::max());
+    for (auto &cost_images : images) {
+      int succ_g = g + cost_images.first;
+      if (succ_g <= segment_lo || succ_g > segment_hi) {
+        continue;
+      }
+      Bucket &bucket = open[succ_g];
+      bucket.insert(bucket.end(), cost_images.second.begin(),
+                    cost_images.second.end());
+    }
+  };
+
+  // All predecessors of the states of the segment with a lower g are in
+  // the layers kept for the lower relay
+  for (int g : layer_costs(segment_lo - max_cost + 1, segment_lo)) {
+    expand(g, layer_at(g));
+  }
+  while (!open.empty()) {
+    int g = open.begin()->first;
+    // Closed states are removed before merging, as in the search
+    Bucket &bucket = open.begin()->second;
+    for (BDD &bdd : bucket) {
+      bdd *= remaining;
+    }
+    mgr->mergeBucket(bucket);
+    BDD states = mgr->zeroBDD();
+    for (const BDD &bdd : bucket) {
+      states += bdd;
+    }
+    open.erase(open.begin());
+
+    // Zero-cost sublayers, each with a predecessor in the previous one
+    Bucket zero_layers;
+    BDD layer = mgr->zeroBDD();
+    while (!states.IsZero()) {
+      zero_layers.push_back(states);
+      layer += states;
+      remaining *= !states;
+      if (!mgr->hasTransitions0()) {
+        break;
+      }
+      Bucket images;
+      mgr->zero_image(relay_fw, states, images, numeric_limits<int>::max());
+      states = mgr->zeroBDD();
+      for (const BDD &image : images) {
+        states += image;
+      }
+      states *= remaining;
+    }
+    if (zero_layers.empty()) {
+      continue;
     }
-    res += pair.second;
+    segment_closed[g] = layer;
+    if (mgr->hasTransitions0()) {
+      segment_zero_closed[g].swap(zero_layers);
+    }
+    expand(g, layer);
+  }
+  cout << "Regenerated closed layers (" << segment_lo << ", " << segment_hi
+       << "]: " << segment_closed.size() << " layers, " << timer << endl;
+}
+
+BDD ClosedList::getPartialClosed(int upper_bound) const {
+  assert(relay_interval == 0);
+  if (!cumulative_sets) {
+    return getClosedBetween(0, upper_bound);
+  }
+  auto it = std::upper_bound(
+      closedUpTo.begin(), closedUpTo.end(), upper_bound,
+      [](int value, const pair<int, BDD> &entry) { return value < entry.first; });
+  if (it == closedUpTo.begin()) {
+    return mgr->zeroBDD();
+  }
+  return (it - 1)->second;
+}
+
+BDD ClosedList::getClosedBetween(int min_h, int max_h) const {
+  BDD res = mgr->zeroBDD();
+  for (int h : layer_costs(min_h, max_h)) {
+    res += layer_at(h);
   }
   return res;
 }
 
+size_t ClosedList::first_intersecting(const BDD &states, size_t begin,
+                                      size_t end) const {
+  // The cumulative sets grow with the index
+  while (begin < end) {
+    size_t mid = begin + (end - begin) / 2;
+    if ((closedUpTo[mid].second * states).IsZero()) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin;
+}
+
 SymSolutionCut ClosedList::getCheapestCut(const BDD &states, int g,
                                           bool fw) const {
+  assert(relay_interval == 0);
   BDD cut_candidate = states * closedTotal;
   if (cut_candidate.IsZero()) {
     return SymSolutionCut();
   }
 
-  for (const auto &closedH : closed) {
-    int h = closedH.first;
-
-    BDD cut = closedH.second * cut_candidate;
-    if (!cut.IsZero()) {
-      if (fw) {
-        return SymSolutionCut(g, h, cut);
-      } else {
-        return SymSolutionCut(h, g, cut);
+  if (!cumulative_sets) {
+    for (int h : layer_costs(0, numeric_limits<int>::max())) {
+      BDD cut = intersection_at(h, cut_candidate);
+      if (!cut.IsZero()) {
+        return fw ? SymSolutionCut(g, h, cut) : SymSolutionCut(h, g, cut);
       }
     }
+    // The states of closedTotal are closed in some layer
+    cerr << "Inconsistent cut result" << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+  }
+
+  // The last cumulative set is closedTotal, so there is a cut
+  size_t i = first_intersecting(cut_candidate, 0, closedUpTo.size() - 1);
+  int h = closedUpTo[i].first;
+  BDD cut = intersection_at(h, cut_candidate);
+  assert(!cut.IsZero());
+  if (fw) {
+    return SymSolutionCut(g, h, cut);
+  } else {
+    return SymSolutionCut(h, g, cut);
   }
-  std::cerr << "Inconsitent cut result" << std::endl;
-  exit(0);
-  return SymSolutionCut();
 }
 
 std::vector<SymSolutionCut> ClosedList::getAllCuts(const BDD &states, int g,
-                                                   bool fw,
-                                                   int lower_bound) const {
+                                                   bool fw, int lower_bound,
+                                                   int upper_bound) const {
+  assert(relay_interval == 0);
   std::vector<SymSolutionCut> result;
   BDD cut_candidate = states * closedTotal;
-  if (!cut_candidate.IsZero()) {
-    for (const auto &closedH : closed) {
-      int h = closedH.first;
-
-      /* Here we also need to consider higher costs due to the architecture
-       of symBD. Otherwise their occur problems in
-       */
-      if (g + h < lower_bound) {
-        continue;
-      }
+  if (cut_candidate.IsZero()) {
+    return result;
+  }
 
-      // cout << "Check cut of g=" << g << " with h=" << h << endl;
-      BDD cut = closedH.second * cut_candidate;
-      if (!cut.IsZero()) {
-        if (fw) {
-          result.emplace_back(g, h, cut);
-        } else {
-          result.emplace_back(h, g, cut);
-        }
+  // Layers with lower_bound - g <= h < upper_bound - g. Layers with higher
+  // costs than the current minimum are also needed due to the architecture
+  // of symBD.
+  auto add_cut = [&](int h) {
+    BDD cut = intersection_at(h, cut_candidate);
+    if (!cut.IsZero()) {
+      if (fw) {
+        result.emplace_back(g, h, cut);
+      } else {
+        result.emplace_back(h, g, cut);
+      }
+    }
+  };
+  if (!cumulative_sets) {
+    long min_layer = max(0L, (long)lower_bound - g);
+    long max_layer =
+        min((long)numeric_limits<int>::max(), (long)upper_bound - g - 1);
+    if (min_layer <= max_layer) {
+      for (int h : layer_costs(min_layer, max_layer)) {
+        add_cut(h);
       }
     }
+    return result;
+  }
+
+  auto h_less = [](const pair<int, BDD> &entry, long value) {
+    return entry.first < value;
+  };
+  size_t begin = std::lower_bound(closedUpTo.begin(), closedUpTo.end(),
+                                  (long)lower_bound - g, h_less) -
+                 closedUpTo.begin();
+  size_t end = std::lower_bound(closedUpTo.begin(), closedUpTo.end(),
+                                (long)upper_bound - g, h_less) -
+               closedUpTo.begin();
+  if (begin == end) {
+    return result;
+  }
+
+  // Skip the layers of the window before the first one with a cut. States
+  // may be closed in several layers (top-k), so all later layers of the
+  // window are checked.
+  size_t first = first_intersecting(cut_candidate, begin, end);
+  for (size_t i = first; i < end; ++i) {
+    add_cut(closedUpTo[i].first);
   }
   return result;
 }
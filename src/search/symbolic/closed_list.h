@@ -5,6 +5,7 @@
 #include "sym_state_space_manager.h"
 #include "sym_variables.h"
 
+#include <limits>
 #include <map>
 #include <set>
 #include <vector>
@@ -19,7 +20,9 @@ class ClosedList {
 private:
   SymStateSpaceManager *mgr; // Symbolic manager to perform bdd operations
 
-  std::map<int, BDD> closed; // Mapping from cost to set of states
+  // Mapping from cost to set of states. With delta layers, only the layer
+  // being closed is materialized.
+  std::map<int, BDD> closed;
 
   // Auxiliar BDDs for the number of 0-cost action steps
   // ALERT: The information here might be wrong
@@ -28,27 +31,110 @@ private:
   std::map<int, std::vector<BDD>> zeroCostClosed;
   BDD closedTotal; // All closed states.
 
+  /*
+   * Delta layers (only with zero-cost transitions): the sublayers of
+   * zeroCostClosed[h] are disjoint, i.e., each one only contains the states
+   * that were not closed with h yet, and closed[h] is their disjunction,
+   * which is only kept for the last h closed, to compute the deltas. Other
+   * layers are built on demand and not cached.
+   */
+  bool delta_layers;
+  int last_h; // Last h closed
+
+  bool stores_deltas() const;
+  // Layer h, built from its sublayers if it is not materialized
+  BDD layer_at(int h) const;
+  // States of layer h, without materializing it
+  BDD intersection_at(int h, const BDD &states) const;
+  // Costs of the closed layers with min_h <= h <= max_h (materialized or not)
+  std::vector<int> layer_costs(int min_h, int max_h) const;
+
+  // Cumulative closed sets in increasing h: closedUpTo[i].second contains all
+  // states closed with h <= closedUpTo[i].first. Solution cuts use them to
+  // find the relevant layers by binary search. They are only maintained
+  // with cumulative_sets, since they (roughly) double the memory of the
+  // closed list; otherwise, the cuts scan the layers.
+  bool cumulative_sets;
+  std::vector<std::pair<int, BDD>> closedUpTo;
+
+  // Index of the first entry of closedUpTo in [begin, end) whose states
+  // intersect states, or end if there is none
+  size_t first_intersecting(const BDD &states, size_t begin, size_t end) const;
+
+  /*
+   * Relay mode (relay_interval > 0), only for plan reconstruction of a
+   * single plan in unidirectional search. Relays are the multiples r of
+   * relay_interval, and only the layers with r - max_cost < h <= r are kept,
+   * i.e., those that contain all predecessors of the states closed after r.
+   * closedUpTo only contains the states closed up to each relay that has
+   * been passed. The dropped layers between two relays are regenerated on
+   * demand by a search from the kept layers of the lower relay that only
+   * expands states of closedTotal, so they are the same as the dropped ones.
+   */
+  int relay_interval;
+  bool relay_fw; // Direction of the search
+  int max_cost;
+  int max_h; // Highest h closed so far
+
+  // Last regenerated segment of layers, with lo < h <= hi
+  mutable int segment_lo, segment_hi;
+  mutable std::map<int, BDD> segment_closed;
+  mutable std::map<int, std::vector<BDD>> segment_zero_closed;
+
+  bool keeps_layer(int h) const;
+  void regenerate_segment(int h) const;
+
+  bool dropped_layer(int h) const;
+  // Sublayers of h, regenerating them if they have been dropped
+  const std::map<int, std::vector<BDD>> &zero_layers_with(int h) const;
+
 public:
   ClosedList();
   virtual ~ClosedList(){};
   void init(SymStateSpaceManager *manager);
   void init(SymStateSpaceManager *manager, const ClosedList &other);
 
+  // Must be set before init. Layers must then be inserted in increasing h,
+  // and the cuts (getCheapestCut, getAllCuts and getPartialClosed) are no
+  // longer available.
+  void set_relays(int interval, bool forward);
+
+  // Must be set before init
+  void set_delta_layers(bool delta) { delta_layers = delta; }
+
+  // Maintains the cumulative closed sets from now on, which speeds up the
+  // cut queries. Only worth it for closed lists that are queried in each
+  // step, i.e., those of the opposite direction of bidirectional searches.
+  // Ignored with delta layers, which must be set before.
+  void enable_cumulative_sets();
+
   void insert(int h, const BDD &S);
 
   BDD getPartialClosed(int upper_bound) const;
 
+  // States closed with min_h <= h <= max_h
+  BDD getClosedBetween(int min_h, int max_h) const;
+
   virtual SymSolutionCut getCheapestCut(const BDD &states, int g,
                                         bool fw) const;
 
+  // Only cuts with lower_bound <= g + h < upper_bound are returned
   virtual std::vector<SymSolutionCut>
-  getAllCuts(const BDD &states, int g, bool fw, int lower_bound) const;
+  getAllCuts(const BDD &states, int g, bool fw, int lower_bound,
+             int upper_bound = std::numeric_limits<int>::max()) const;
 
   inline BDD getClosed() const { return closedTotal; }
 
   virtual BDD notClosed() const { return !closedTotal; }
 
-  inline std::map<int, BDD> getClosedList() const { return closed; }
+  // Materializes all layers
+  std::map<int, BDD> getClosedList() const;
+
+  // Appends the BDDs that are held by the layers (materialized or not)
+  void getBDDs(Bucket &bdds) const;
+
+  // Number of sublayers and BDD nodes held by each layer
+  void print_layer_memory() const;
 
   BDD get_start_states() const {
     if (get_num_zero_closed_layers(0) == 0) {
@@ -57,29 +143,26 @@ public:
     return get_zero_closed_at(0, 0);
   }
 
-  inline BDD get_closed_at(int h) const {
-    if (!closed.count(h)) {
-      return mgr->zeroBDD();
-    }
-    return closed.at(h);
-  }
+  BDD get_closed_at(int h) const;
 
   inline BDD get_zero_closed_at(int h, int layer) const {
-    return zeroCostClosed.at(h).at(layer);
+    return zero_layers_with(h).at(h).at(layer);
   }
 
   inline size_t get_num_zero_closed_layers(int h) const {
-    if (zeroCostClosed.count(h) == 0) {
+    const std::map<int, std::vector<BDD>> &zero_layers = zero_layers_with(h);
+    if (zero_layers.count(h) == 0) {
       return 0;
     }
-    return zeroCostClosed.at(h).size();
+    return zero_layers.at(h).size();
   }
 
   inline size_t get_zero_cut(int h, const BDD &bdd) const {
     size_t i = 0;
     if (get_num_zero_closed_layers(h)) {
-      for (; i < zeroCostClosed.at(h).size(); i++) {
-        BDD intersection = zeroCostClosed.at(h).at(i) * bdd;
+      const std::vector<BDD> &zero_layers = zero_layers_with(h).at(h);
+      for (; i < zero_layers.size(); i++) {
+        BDD intersection = zero_layers.at(i) * bdd;
         if (!intersection.IsZero()) {
           break;
         }
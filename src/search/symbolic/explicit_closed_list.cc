@@ -0,0 +1,167 @@
+#include "explicit_closed_list.h"
+
+#include "../utils/system.h"
+#include "../utils/timer.h"
+#include "sym_bucket.h"
+#include "transition_relation.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+using namespace std;
+
+namespace symbolic {
+
+ExplicitClosedList::ExplicitClosedList(SymVariables *vars,
+                                       const TaskProxy &task_proxy,
+                                       int batch_size)
+    : vars(vars), task_proxy(task_proxy), batch_size(batch_size),
+      closed_total(vars->zeroBDD()), pending_g(0), pending_depth(0),
+      num_closed(0) {}
+
+BDD ExplicitClosedList::get_state_bdd(const vector<int> &state) const {
+  // The cube is built at once, without intermediate BDDs that would become
+  // garbage. Derived variables are not part of symbolic states.
+  Cudd *manager = vars->get_manager();
+  vector<int> cube(manager->ReadSize(), 2);
+  for (VariableProxy var : task_proxy.get_variables()) {
+    if (var.is_derived()) {
+      continue;
+    }
+    const vector<int> &bdd_vars = vars->vars_index_pre(var.get_id());
+    for (size_t j = 0; j < bdd_vars.size(); ++j) {
+      cube[bdd_vars[j]] = (state[var.get_id()] >> j) % 2;
+    }
+  }
+  return BDD(*manager, Cudd_CubeArrayToBdd(manager->getManager(), &cube[0]));
+}
+
+void ExplicitClosedList::insert(int g, int depth, const vector<int> &state) {
+  assert(make_pair(g, depth) >= make_pair(pending_g, pending_depth));
+  if (g != pending_g || depth != pending_depth ||
+      pending.size() >= batch_size) {
+    flush();
+    pending_g = g;
+    pending_depth = depth;
+  }
+  if (pending.insert(state).second) {
+    ++num_closed;
+  }
+}
+
+bool ExplicitClosedList::contains(const vector<int> &state) const {
+  if (pending.count(state)) {
+    return true;
+  }
+  return closed_total.Eval(vars->getBinaryDescription(state)).IsOne();
+}
+
+void ExplicitClosedList::flush() {
+  if (pending.empty()) {
+    return;
+  }
+  // Balanced disjunction, so that most disjunctions are on small BDDs
+  Bucket bdds;
+  bdds.reserve(pending.size());
+  for (const vector<int> &state : pending) {
+    bdds.push_back(get_state_bdd(state));
+  }
+  while (bdds.size() > 1) {
+    size_t num_merged = (bdds.size() + 1) / 2;
+    for (size_t i = 0; i < num_merged; ++i) {
+      bdds[i] = 2 * i + 1 < bdds.size() ? bdds[2 * i] + bdds[2 * i + 1]
+                                        : bdds[2 * i];
+    }
+    bdds.resize(num_merged);
+  }
+
+  vector<BDD> &layer = closed[pending_g];
+  if (static_cast<int>(layer.size()) <= pending_depth) {
+    layer.resize(pending_depth + 1, vars->zeroBDD());
+  }
+  layer[pending_depth] += bdds[0];
+  closed_total += bdds[0];
+
+  utils::HashSet<vector<int>>().swap(pending);
+}
+
+Plan ExplicitClosedList::extract_path(int g, int depth,
+                                      const vector<int> &state) {
+  flush();
+  utils::Timer timer;
+  map<int, vector<TransitionRelation>> trs;
+  for (OperatorProxy op : task_proxy.get_operators()) {
+    trs[op.get_cost()].emplace_back(vars, OperatorID(op.get_id()),
+                                    op.get_cost());
+    trs[op.get_cost()].back().init();
+  }
+
+  // Regress to the previous sublayer of the same g with a zero-cost
+  // operator, or to any sublayer of a lower g with a cost operator. The
+  // initial state is the only state closed with g = 0 and depth = 0.
+  Plan plan;
+  BDD cut = get_state_bdd(state);
+  while (g > 0 || depth > 0) {
+    bool found = false;
+    if (depth > 0) {
+      for (const TransitionRelation &tr : trs[0]) {
+        BDD pre = tr.preimage(cut) * closed.at(g).at(depth - 1);
+        if (!pre.IsZero()) {
+          plan.push_back(*tr.getOpsIds().begin());
+          cut = pre;
+          --depth;
+          found = true;
+          break;
+        }
+      }
+    } else {
+      for (const auto &cost_trs : trs) {
+        int pre_g = g - cost_trs.first;
+        if (cost_trs.first == 0 || pre_g < 0 || !closed.count(pre_g)) {
+          continue;
+        }
+        const vector<BDD> &layer = closed.at(pre_g);
+        for (const TransitionRelation &tr : cost_trs.second) {
+          BDD pre = tr.preimage(cut);
+          for (size_t pre_depth = 0; pre_depth < layer.size(); ++pre_depth) {
+            BDD pre_closed = pre * layer[pre_depth];
+            if (!pre_closed.IsZero()) {
+              plan.push_back(*tr.getOpsIds().begin());
+              cut = pre_closed;
+              g = pre_g;
+              depth = pre_depth;
+              found = true;
+              break;
+            }
+          }
+          if (found) {
+            break;
+          }
+        }
+        if (found) {
+          break;
+        }
+      }
+    }
+    if (!found) {
+      cerr << "No predecessor found in the closed list" << endl;
+      utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+  }
+  reverse(plan.begin(), plan.end());
+  cout << "Path extracted from the closed list: " << timer << endl;
+  return plan;
+}
+
+void ExplicitClosedList::print_statistics() const {
+  size_t num_sublayers = 0;
+  for (const auto &layer : closed) {
+    num_sublayers += layer.second.size();
+  }
+  cout << "Closed states: " << num_closed << endl;
+  cout << "Closed list: " << closed.size() << " layers, " << num_sublayers
+       << " sublayers, " << closed_total.nodeCount() << " nodes" << endl;
+}
+
+} // namespace symbolic
@@ -0,0 +1,65 @@
+#ifndef SYMBOLIC_EXPLICIT_CLOSED_LIST_H
+#define SYMBOLIC_EXPLICIT_CLOSED_LIST_H
+
+#include "../plan_manager.h"
+#include "../task_proxy.h"
+#include "../utils/hash.h"
+#include "sym_variables.h"
+
+#include <map>
+#include <vector>
+
+namespace symbolic {
+/*
+ * Closed list of an explicit search that stores the closed states as BDDs
+ * instead of registering them. States are closed by increasing g and, within
+ * the same g, by increasing zero-cost depth (number of zero-cost operators
+ * since the last cost operator), so that each (g, depth) sublayer only
+ * contains states reached from the previous ones.
+ *
+ * Closed states are first collected explicitly and inserted into the BDDs in
+ * batches. Membership is tested on the binary description of the state.
+ * Parent pointers are not stored: paths are extracted by regressing through
+ * the closed sublayers with the transition relations of the operators.
+ */
+class ExplicitClosedList {
+  SymVariables *vars;
+  TaskProxy task_proxy;
+  size_t batch_size;
+
+  // Closed states per g and zero-cost depth, and all closed states
+  std::map<int, std::vector<BDD>> closed;
+  BDD closed_total;
+
+  // States closed since the last flush, all with the same g and depth
+  int pending_g;
+  int pending_depth;
+  utils::HashSet<std::vector<int>> pending;
+
+  long num_closed;
+
+  BDD get_state_bdd(const std::vector<int> &state) const;
+
+public:
+  ExplicitClosedList(SymVariables *vars, const TaskProxy &task_proxy,
+                     int batch_size);
+
+  // States must be inserted in increasing (g, depth) order
+  void insert(int g, int depth, const std::vector<int> &state);
+
+  bool contains(const std::vector<int> &state) const;
+
+  // Inserts the pending states into the BDDs
+  void flush();
+
+  // Operators that lead from the initial state to the given state, which
+  // must have been closed with g and depth
+  Plan extract_path(int g, int depth, const std::vector<int> &state);
+
+  long get_num_closed() const { return num_closed; }
+
+  void print_statistics() const;
+};
+} // namespace symbolic
+
+#endif
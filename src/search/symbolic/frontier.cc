@@ -2,6 +2,7 @@
 
 #include "sym_state_space_manager.h"
 
+#include "../utils/system.h"
 #include "../utils/timer.h"
 
 using namespace std;
@@ -10,11 +11,18 @@ using utils::Timer;
 
 namespace symbolic {
 
-Frontier::Frontier() : mgr(nullptr), g_value(0) {}
+Frontier::Frontier() : mgr(nullptr), num_filtered(0), g_value(0) {}
 
 void Frontier::init(SymStateSpaceManager *mgr_, const BDD &bdd) {
   mgr = mgr_;
   Sfilter.push_back(bdd);
+  num_filtered = 0;
+  g_value = 0;
+}
+
+void Frontier::init(SymStateSpaceManager *mgr_) {
+  mgr = mgr_;
+  num_filtered = 0;
   g_value = 0;
 }
 
@@ -22,12 +30,32 @@ void Frontier::set(int g, Bucket &bdd) {
   assert(empty());
   g_value = g;
   Sfilter.swap(bdd);
+  num_filtered = 0;
+}
+
+void Frontier::filter_mutex(bool fw, bool initialization) {
+  assert(Smerge.empty() && Szero.empty() && S.empty());
+  int numFiltered = mgr->filterMutex(Sfilter, fw, initialization);
+  Bucket unfiltered(std::begin(Sfilter) + numFiltered, std::end(Sfilter));
+  Sfilter.resize(numFiltered);
+  removeZero(Sfilter);
+  removeZero(unfiltered);
+  num_filtered = Sfilter.size();
+  Sfilter.insert(std::end(Sfilter), std::begin(unfiltered),
+                 std::end(unfiltered));
 }
 
 bool Frontier::nextStepZero() const {
   return !Szero.empty() || (S.empty() && mgr->hasTransitions0());
 }
 
+// Splits the time of a prepare step into filter and merge time
+static Result prepared(Result res, double filter_time) {
+  res.filter_time = filter_time;
+  res.merge_time = res.time_spent - filter_time;
+  return res;
+}
+
 Result Frontier::prepare(int maxTime, int maxNodes, bool fw,
                          bool initialization) {
   Timer filterTime;
@@ -36,6 +64,11 @@ Result Frontier::prepare(int maxTime, int maxNodes, bool fw,
     // uses pop_time). This is only to reuse the most resources
     // possible.  mergeBucket(Sfilter, p.max_pop_time,
     // p.max_pop_nodes); it has been merged in pop
+    // BDDs filtered when the frontier was popped are moved as they are
+    Smerge.insert(std::end(Smerge), std::begin(Sfilter),
+                  std::begin(Sfilter) + num_filtered);
+    Sfilter.erase(std::begin(Sfilter), std::begin(Sfilter) + num_filtered);
+    num_filtered = 0;
     int numFiltered =
         mgr->filterMutexBucket(Sfilter, fw, initialization, maxTime, maxNodes);
     if (numFiltered > 0) {
@@ -46,16 +79,20 @@ Result Frontier::prepare(int maxTime, int maxNodes, bool fw,
       Bucket().swap(Sfilter);
     } else {
       Sfilter.erase(std::begin(Sfilter), std::begin(Sfilter) + numFiltered);
-      return Result(TruncatedReason::FILTER_MUTEX, filterTime());
+      Result res(TruncatedReason::FILTER_MUTEX, filterTime());
+      res.filter_time = res.time_spent;
+      return res;
     }
   }
+  double filter_time = filterTime();
 
   if (!Smerge.empty()) {
     if (Smerge.size() > 1) {
       int remainingTime = maxTime - 1000 * filterTime();
       if (remainingTime < 0 ||
           !mgr->mergeBucket(Smerge, remainingTime, maxNodes)) {
-        return Result(TruncatedReason::MERGE_BUCKET, filterTime());
+        return prepared(Result(TruncatedReason::MERGE_BUCKET, filterTime()),
+                        filter_time);
       }
     }
 
@@ -77,12 +114,14 @@ Result Frontier::prepare(int maxTime, int maxNodes, bool fw,
     if (S.size() > 1) {
       int remainingTime = maxTime - 1000 * filterTime();
       if (remainingTime < 0 || !mgr->mergeBucket(S, remainingTime, maxNodes)) {
-        return Result(TruncatedReason::MERGE_BUCKET_COST, filterTime());
+        return prepared(
+            Result(TruncatedReason::MERGE_BUCKET_COST, filterTime()),
+            filter_time);
       }
     }
   }
 
-  return Result(filterTime());
+  return prepared(Result(filterTime()), filter_time);
 }
 
 bool Frontier::bucketReady() const {
@@ -117,7 +156,23 @@ int Frontier::buckets() const {
   }
 }
 
-ResultExpansion Frontier::expand_zero(int maxTime, int maxNodes, bool fw) {
+void Frontier::getBuckets(Bucket &res) const {
+  for (const Bucket *bucket : {&Sfilter, &Smerge, &Szero, &S}) {
+    res.insert(res.end(), bucket->begin(), bucket->end());
+  }
+  for (const auto &img : Simg) {
+    for (const auto &cost_bucket : img) {
+      res.insert(res.end(), cost_bucket.second.begin(),
+                 cost_bucket.second.end());
+    }
+  }
+}
+
+ResultExpansion Frontier::expand_zero(int maxTime, int maxNodes, bool fw,
+                                      const BDD &closed, bool initialization) {
+  if (mgr->getParams().zero_cost_expansion != ZeroCostExpansion::BFS) {
+    return expand_zero_closure(maxTime, maxNodes, fw, closed, initialization);
+  }
 
   // Image with respect to 0-cost actions
   assert(expansionReady() && nodeCount(Szero) <= maxNodes);
@@ -126,11 +181,23 @@ ResultExpansion Frontier::expand_zero(int maxTime, int maxNodes, bool fw) {
   mgr->setTimeLimit(maxTime);
   // Compute image, storing the result on Simg
   try {
-    int numImagesComputed = 0;
+    int num_splits = 0;
     for (size_t i = 0; i < Szero.size(); i++) {
+      if (utils::is_cancellation_requested()) {
+        throw BDDError();
+      }
+      Bucket img;
+      try {
+        mgr->zero_image(fw, Szero[i], img, maxNodes);
+      } catch (BDDError e) {
+        if (!split(Szero, i, num_splits)) {
+          throw;
+        }
+        --i; // Retry with the first part
+        continue;
+      }
       Simg.push_back(map<int, Bucket>());
-      mgr->zero_image(fw, Szero[i], Simg[i][0], maxNodes);
-      ++numImagesComputed;
+      Simg.back()[0].swap(img);
     }
     mgr->unsetTimeLimit();
   } catch (BDDError e) {
@@ -143,15 +210,67 @@ ResultExpansion Frontier::expand_zero(int maxTime, int maxNodes, bool fw) {
   return ResultExpansion(true, Simg, image_time());
 }
 
+ResultExpansion Frontier::expand_zero_closure(int maxTime, int maxNodes,
+                                              bool fw, const BDD &closed,
+                                              bool initialization) {
+  assert(expansionReady() && nodeCount(Szero) <= maxNodes);
+  Timer image_time;
+
+  mgr->setTimeLimit(maxTime);
+  Bucket zero_layers;
+  try {
+    BDD reached = closed;
+    for (const BDD &bdd : Szero) {
+      if (utils::is_cancellation_requested()) {
+        throw BDDError();
+      }
+      size_t num_layers = zero_layers.size();
+      mgr->zero_closure(fw, bdd, reached, zero_layers, maxNodes,
+                        initialization);
+      reached += bdd;
+      for (size_t i = num_layers; i < zero_layers.size(); ++i) {
+        reached += zero_layers[i];
+      }
+    }
+    mgr->unsetTimeLimit();
+  } catch (BDDError e) {
+    mgr->unsetTimeLimit();
+    return ResultExpansion(true, TruncatedReason::IMAGE_ZERO, image_time());
+  }
+
+  // All states reachable with zero-cost actions are expanded with the
+  // cost actions next
+  Bucket().swap(Szero);
+  S.insert(std::end(S), std::begin(zero_layers), std::end(zero_layers));
+
+  ResultExpansion res(true, Simg, image_time());
+  res.zero_layers.swap(zero_layers);
+  return res;
+}
+
 ResultExpansion Frontier::expand_cost(int maxTime, int maxNodes, bool fw) {
   assert(expansionReady());
   assert(nodeCount(S) <= maxNodes);
   Timer image_time;
   mgr->setTimeLimit(maxTime);
   try {
+    int num_splits = 0;
     for (size_t i = 0; i < S.size(); i++) {
+      if (utils::is_cancellation_requested()) {
+        throw BDDError();
+      }
+      map<int, Bucket> img;
+      try {
+        mgr->cost_image(fw, S[i], img, maxNodes);
+      } catch (BDDError e) {
+        if (!split(S, i, num_splits)) {
+          throw;
+        }
+        --i; // Retry with the first part
+        continue;
+      }
       Simg.push_back(map<int, Bucket>());
-      mgr->cost_image(fw, S[i], Simg[i], maxNodes);
+      Simg.back().swap(img);
     }
     mgr->unsetTimeLimit();
   } catch (BDDError e) {
@@ -165,6 +284,21 @@ ResultExpansion Frontier::expand_cost(int maxTime, int maxNodes, bool fw) {
   return ResultExpansion(false, Simg, image_time());
 }
 
+bool Frontier::split(Bucket &bucket, size_t i, int &num_splits) {
+  if (num_splits >= mgr->getParams().max_image_splits ||
+      !mgr->nodesExceeded()) {
+    return false;
+  }
+  BDD part1, part2;
+  if (!mgr->split(bucket[i], part1, part2)) {
+    return false;
+  }
+  bucket[i] = part1;
+  bucket.insert(bucket.begin() + i + 1, part2);
+  ++num_splits;
+  return true;
+}
+
 std::ostream &operator<<(std::ostream &os, const Frontier &frontier) {
   if (!frontier.Sfilter.empty())
     os << "Sf: " << nodeCount(frontier.Sfilter) << " ";
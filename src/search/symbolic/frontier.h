@@ -15,16 +15,21 @@ public:
   bool ok;
   TruncatedReason truncated_reason;
   double time_spent;
+  double filter_time, merge_time; // Only set when preparing the frontier
 
-  Result(double t) : ok(true), time_spent(t) {}
+  Result(double t) : ok(true), time_spent(t), filter_time(0), merge_time(0) {}
   Result(TruncatedReason reason, double t)
-      : ok(false), truncated_reason(reason), time_spent(t) {}
+      : ok(false), truncated_reason(reason), time_spent(t), filter_time(0),
+        merge_time(0) {}
 };
 
 class ResultExpansion : public Result {
 public:
   bool step_zero;
   std::vector<std::map<int, Bucket>> buckets;
+  // Zero-cost layers expanded up to a fixpoint (chaining or saturation).
+  // They are already part of the frontier and only need to be closed.
+  Bucket zero_layers;
   ResultExpansion(bool step_zero_, std::vector<std::map<int, Bucket>> &buckets_,
                   double t)
       : Result(t), step_zero(step_zero_) {
@@ -44,19 +49,31 @@ class Frontier { // Current states extracted from the open list
   Bucket Szero;   // bucket to expand 0-cost transitions
   Bucket S;       // bucket to expand cost transitions
 
+  // Number of BDDs at the front of Sfilter that are already mutex-filtered
+  size_t num_filtered;
+
   // bucket to store temporary image results in expand_zero() and expand_cost()
   // For each BDD in Szero or S, stores a map with pairs <cost, resImage>
   std::vector<std::map<int, Bucket>> Simg;
 
   int g_value;
 
-  ResultExpansion expand_zero(int maxTime, int maxNodes, bool fw);
+  ResultExpansion expand_zero(int maxTime, int maxNodes, bool fw,
+                              const BDD &closed, bool initialization);
+  ResultExpansion expand_zero_closure(int maxTime, int maxNodes, bool fw,
+                                      const BDD &closed, bool initialization);
   ResultExpansion expand_cost(int maxTime, int maxNodes, bool fw);
 
+  // Replaces bucket[i] by two disjoint parts if its image exceeded the node
+  // limit and the frontier has been split less than max_image_splits times
+  bool split(Bucket &bucket, size_t i, int &num_splits);
+
 public:
   Frontier();
 
   void init(SymStateSpaceManager *mgr, const BDD &bdd);
+  // Empty frontier: the first bucket is popped from the open list
+  void init(SymStateSpaceManager *mgr);
   void set(int g, Bucket &open);
 
   Result prepare(int maxTime, int maxNodes, bool fw, bool initialization);
@@ -69,6 +86,9 @@ public:
   int nodes() const;
   int buckets() const;
 
+  // Appends all BDDs of the frontier (including its images) to res
+  void getBuckets(Bucket &res) const;
+
   int g() const { return g_value; }
 
   Bucket &prepared_bucket() {
@@ -93,10 +113,16 @@ public:
     }
   }
 
-  ResultExpansion expand(int maxTime, int maxNodes, bool fw) {
+  // Filters mutexes of Sfilter within the auxiliary limits. The filtered
+  // BDDs are not filtered again when preparing the frontier.
+  void filter_mutex(bool fw, bool initialization);
+
+  // closed: states not to be included in the zero-cost closure
+  ResultExpansion expand(int maxTime, int maxNodes, bool fw, const BDD &closed,
+                         bool initialization) {
     assert(Smerge.empty() && Sfilter.empty());
     if (!Szero.empty()) {
-      return expand_zero(maxTime, maxNodes, fw);
+      return expand_zero(maxTime, maxNodes, fw, closed, initialization);
     }
 
     assert(!S.empty());
@@ -30,6 +30,7 @@ void OpenList::pop(Frontier &frontier) {
   int g = open.begin()->first;
   frontier.set(g, open.begin()->second);
   open.erase(g);
+  num_contained.erase(g);
 }
 
 int OpenList::minG() const {
@@ -45,6 +46,26 @@ bool OpenList::contains_any_state(const BDD &bdd) const {
   return false;
 }
 
+bool OpenList::contains_state_outside(const BDD &states) {
+  for (auto &key : open) {
+    const Bucket &bucket = key.second;
+    // Buckets only grow at the end, so the checked prefix stays contained
+    size_t &checked = num_contained[key.first];
+    for (; checked < bucket.size(); ++checked) {
+      if (!bucket[checked].Leq(states)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void OpenList::getBuckets(Bucket &res) const {
+  for (const auto &key : open) {
+    res.insert(res.end(), key.second.begin(), key.second.end());
+  }
+}
+
 std::ostream &operator<<(std::ostream &os, const OpenList &exp) {
   os << " open{";
   for (auto &o : exp.open) {
@@ -12,6 +12,10 @@ class Frontier;
 class OpenList {
   std::map<int, Bucket> open; // States in open with unkwown h-value
 
+  // Number of BDDs at the front of each bucket that are known to be
+  // contained in the states of contains_state_outside
+  std::map<int, size_t> num_contained;
+
   // At any point in the search we can close all the states in
   // open[minG()] because they cannot be generated with lower
   // cost. Doing that we can set hNotClosed to the next bucket.
@@ -36,6 +40,15 @@ public:
 
   bool contains_any_state(const BDD &bdd) const;
 
+  // Returns true if open contains a state that is not in states. BDDs that
+  // were contained in the states of a previous call are not checked again,
+  // so states must only grow between calls until reset_containment().
+  bool contains_state_outside(const BDD &states);
+  void reset_containment() { num_contained.clear(); }
+
+  // Appends all BDDs in open to res
+  void getBuckets(Bucket &res) const;
+
   friend std::ostream &operator<<(std::ostream &os, const OpenList &open);
 };
 } // namespace symbolic
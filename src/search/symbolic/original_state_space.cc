@@ -3,10 +3,16 @@
 #include "../abstract_task.h"
 #include "../mutex_group.h"
 #include "../task_utils/task_properties.h"
+#include "../utils/timer.h"
 #include "sym_axiom/sym_axiom_compilation.h"
+#include "sym_tr_cache.h"
+#include "transition_relation.h"
 
 #include <algorithm>
+#include <exception>
 #include <limits>
+#include <memory>
+#include <thread>
 
 using namespace std;
 
@@ -32,8 +38,30 @@ OriginalStateSpace::OriginalStateSpace(SymVariables *v,
   }
 
   init_mutex(tasks::g_root_task->get_mutex_groups());
-  create_single_trs();
+
+  unique_ptr<SymTRCache> tr_cache;
+  if (!p.tr_cache.empty()) {
+    tr_cache = unique_ptr<SymTRCache>(new SymTRCache(p.tr_cache, *vars, p));
+    map<int, vector<TransitionRelation>> trs;
+    utils::Timer load_timer;
+    if (tr_cache->load(vars, indTRs, trs)) {
+      cout << "TRs loaded from cache: " << load_timer << endl;
+      set_transitions(move(trs));
+      return;
+    }
+  }
+
+  utils::Timer tr_timer;
+  if (p.tr_threads > 1) {
+    create_single_trs_parallel();
+  } else {
+    create_single_trs();
+  }
   init_transitions(indTRs);
+  cout << "TRs created: " << tr_timer << endl;
+  if (tr_cache) {
+    tr_cache->store(indTRs, transitions);
+  }
 }
 
 void OriginalStateSpace::create_single_trs() {
@@ -58,6 +86,87 @@ void OriginalStateSpace::create_single_trs() {
   }
 }
 
+static vector<vector<BDD>> transfer_bdds(const vector<vector<BDD>> &bdds,
+                                        Cudd &manager) {
+  vector<vector<BDD>> res(bdds.size());
+  for (size_t i = 0; i < bdds.size(); ++i) {
+    for (const BDD &bdd : bdds[i]) {
+      res[i].push_back(bdd.Transfer(manager));
+    }
+  }
+  return res;
+}
+
+namespace {
+struct TRWorker {
+  // Declared first, so that the manager outlives all BDDs below
+  unique_ptr<SymVariables> vars;
+  vector<vector<BDD>> notMutexBDDsByFluentFw, notMutexBDDsByFluentBw;
+  vector<vector<BDD>> exactlyOneBDDsByFluent;
+  vector<TransitionRelation> trs;
+  exception_ptr error;
+};
+} // namespace
+
+void OriginalStateSpace::create_single_trs_parallel() {
+  int num_ops = tasks::g_root_task->get_num_operators();
+  int num_workers = max(1, min(p.tr_threads, num_ops));
+  bool edeletion = p.mutex_type == MutexType::MUTEX_EDELETION;
+
+  // Transfers to and from the workers are done by this thread, as they
+  // access both managers
+  vector<TRWorker> workers(num_workers);
+  for (TRWorker &worker : workers) {
+    worker.vars = vars->create_worker();
+    if (edeletion) {
+      Cudd &manager = *worker.vars->get_manager();
+      worker.notMutexBDDsByFluentFw =
+          transfer_bdds(notMutexBDDsByFluentFw, manager);
+      worker.notMutexBDDsByFluentBw =
+          transfer_bdds(notMutexBDDsByFluentBw, manager);
+      worker.exactlyOneBDDsByFluent =
+          transfer_bdds(exactlyOneBDDsByFluent, manager);
+    }
+  }
+
+  // Operator i is built by worker i % num_workers
+  vector<thread> threads;
+  for (int w = 0; w < num_workers; ++w) {
+    threads.emplace_back([&, w]() {
+      TRWorker &worker = workers[w];
+      try {
+        for (int i = w; i < num_ops; i += num_workers) {
+          int cost = tasks::g_root_task->get_operator_cost(i, false);
+          worker.trs.emplace_back(worker.vars.get(), OperatorID(i), cost);
+          worker.trs.back().init();
+          if (edeletion) {
+            worker.trs.back().edeletion(worker.notMutexBDDsByFluentFw,
+                                        worker.notMutexBDDsByFluentBw,
+                                        worker.exactlyOneBDDsByFluent);
+          }
+        }
+      } catch (...) {
+        worker.error = current_exception();
+      }
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+  for (TRWorker &worker : workers) {
+    if (worker.error) {
+      rethrow_exception(worker.error);
+    }
+  }
+
+  // Same order of the TRs as in create_single_trs
+  for (int i = 0; i < num_ops; i++) {
+    const TransitionRelation &tr =
+        workers[i % num_workers].trs[i / num_workers];
+    indTRs[tr.getCost()].push_back(tr.transfer(vars));
+  }
+}
+
 void OriginalStateSpace::init_mutex(
     const std::vector<MutexGroup> &mutex_groups) {
   // If (a) is initialized OR not using mutex OR edeletion does not need mutex
@@ -8,6 +8,8 @@ namespace symbolic {
 
 class OriginalStateSpace : public SymStateSpaceManager {
   void create_single_trs();
+  // Builds the TRs on p.tr_threads worker managers and transfers them
+  void create_single_trs_parallel();
 
   void init_mutex(const std::vector<MutexGroup> &mutex_groups);
   void init_mutex(const std::vector<MutexGroup> &mutex_groups, bool genMutexBDD,
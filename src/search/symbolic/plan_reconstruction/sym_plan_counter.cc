@@ -0,0 +1,214 @@
+#include "sym_plan_counter.h"
+
+#include "../../tasks/root_task.h"
+#include "../closed_list.h"
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <set>
+#include <sstream>
+
+using namespace std;
+
+namespace symbolic {
+
+// Counts of a layer are rescaled by 2^-SCALE_STEP if they exceed 2^SCALE_STEP
+static const int SCALE_STEP = 512;
+// Largest integer that can be represented exactly by a double
+static const double MAX_EXACT_COUNT = 9007199254740992.0; // 2^53
+
+bool PlanCount::is_infinite() const {
+  return isinf(value);
+}
+
+bool PlanCount::is_exact() const {
+  return exponent == 0 && value <= MAX_EXACT_COUNT;
+}
+
+double PlanCount::log10() const {
+  if (is_zero()) {
+    return -numeric_limits<double>::infinity();
+  }
+  return std::log10(value) + exponent * std::log10(2.0);
+}
+
+ostream &operator<<(ostream &os, const PlanCount &count) {
+  ostringstream out;
+  if (count.is_infinite()) {
+    out << "infinite";
+  } else if (count.is_exact()) {
+    out << fixed << setprecision(0) << count.value;
+  } else {
+    double log_count = count.log10();
+    double exp10 = floor(log_count);
+    out << "~" << fixed << setprecision(6) << pow(10.0, log_count - exp10)
+        << "e+" << setprecision(0) << exp10 << " (log10=" << setprecision(4)
+        << log_count << ")";
+  }
+  return os << out.str();
+}
+
+SymPlanCounter::SymPlanCounter(
+    shared_ptr<SymVariables> sym_vars,
+    const map<int, vector<TransitionRelation>> &trs)
+    : sym_vars(sym_vars), trs(trs) {
+  set<int> all_vars;
+  for (int var = 0; var < tasks::g_root_task->get_num_variables(); ++var) {
+    all_vars.insert(var);
+  }
+  state_cube = sym_vars->getCubePre(all_vars).Add();
+}
+
+ADD SymPlanCounter::successors(const ADD &counts,
+                               const TransitionRelation &tr, bool fw) const {
+  return fw ? tr.image(counts) : tr.preimage(counts);
+}
+
+ADD SymPlanCounter::scale(const ADD &counts, int from_exponent,
+                          int to_exponent) const {
+  if (from_exponent == to_exponent) {
+    return counts;
+  }
+  return counts * sym_vars->get_manager()->constant(
+                      ldexp(1.0, from_exponent - to_exponent));
+}
+
+void SymPlanCounter::normalize(LayerCount &layer) const {
+  double max_value = Cudd_V(layer.counts.FindMax().getNode());
+  while (!isinf(max_value) && max_value > ldexp(1.0, SCALE_STEP)) {
+    layer.counts = scale(layer.counts, 0, SCALE_STEP);
+    layer.exponent += SCALE_STEP;
+    max_value = ldexp(max_value, -SCALE_STEP);
+  }
+}
+
+BDD SymPlanCounter::zero_cost_successors(const BDD &states, bool fw) const {
+  BDD res = sym_vars->zeroBDD();
+  for (const TransitionRelation &tr : trs.at(0)) {
+    res += fw ? tr.image(states) : tr.preimage(states);
+  }
+  return res;
+}
+
+void SymPlanCounter::add_zero_cost_paths(LayerCount &layer, const BDD &domain,
+                                         bool fw) const {
+  // States reachable with zero-cost steps within the domain
+  BDD reached = layer.counts.BddPattern();
+  BDD frontier = reached;
+  while (!frontier.IsZero()) {
+    frontier = zero_cost_successors(frontier, fw) * domain * !reached;
+    reached += frontier;
+  }
+
+  // The states reachable from a zero-cost cycle are those with arbitrarily
+  // long zero-cost paths to them, i.e. the greatest fixpoint of the reached
+  // states with a zero-cost predecessor in the set. They are reached by
+  // infinitely many paths.
+  BDD infinite = reached;
+  while (true) {
+    BDD next = infinite * zero_cost_successors(infinite, fw);
+    if (next == infinite) {
+      break;
+    }
+    infinite = next;
+  }
+
+  // No other state has a predecessor in infinite, and the zero-cost steps
+  // among them are acyclic, so the propagation ends
+  const ADD zero = sym_vars->zeroBDD().Add();
+  const ADD finite_add = (reached * !infinite).Add();
+  layer.counts *= finite_add;
+  ADD delta = layer.counts;
+  while (!(delta == zero)) {
+    ADD next = zero;
+    for (const TransitionRelation &tr : trs.at(0)) {
+      next += successors(delta, tr, fw) * finite_add;
+    }
+    layer.counts += next;
+    delta = next;
+  }
+  if (!infinite.IsZero()) {
+    layer.counts += infinite.Add() * sym_vars->get_manager()->plusInfinity();
+  }
+}
+
+PlanCount SymPlanCounter::sum(const ADD &counts, int exponent) const {
+  ADD total = counts.ExistAbstract(state_cube);
+  return PlanCount(Cudd_V(total.getNode()), exponent);
+}
+
+map<int, PlanCount> SymPlanCounter::count_plans(const ClosedList &closed,
+                                                const BDD &terminal, bool fw,
+                                                int max_cost) const {
+  map<int, PlanCount> result;
+  map<int, LayerCount> layers;
+  const ADD zero = sym_vars->zeroBDD().Add();
+  const ADD terminal_add = terminal.Add();
+  bool has_zero_trs = trs.count(0) > 0;
+
+  // Costs that may contain plans: closed layers and their successor costs
+  // (goal states are not necessarily inserted into the closed list)
+  set<int> costs;
+  for (const auto &closed_layer : closed.getClosedList()) {
+    if (closed_layer.first <= max_cost) {
+      costs.insert(closed_layer.first);
+    }
+  }
+
+  for (int g : costs) {
+    // Paths reaching states of cost g with a cost action (or start states)
+    LayerCount reached{zero, 0};
+    if (g == 0) {
+      reached.counts = closed.get_start_states().Add();
+    }
+    for (const auto &trs_cost : trs) {
+      int cost = trs_cost.first;
+      if (cost > 0 && layers.count(g - cost)) {
+        reached.exponent =
+            max(reached.exponent, layers.at(g - cost).exponent);
+      }
+    }
+    for (const auto &trs_cost : trs) {
+      int cost = trs_cost.first;
+      if (cost == 0 || !layers.count(g - cost)) {
+        continue;
+      }
+      const LayerCount &pre = layers.at(g - cost);
+      ADD pre_counts = scale(pre.counts, pre.exponent, reached.exponent);
+      for (const TransitionRelation &tr : trs_cost.second) {
+        reached.counts += successors(pre_counts, tr, fw);
+      }
+    }
+
+    // Zero-cost steps are propagated within the layer until a fixpoint is
+    // reached (terminal states are not necessarily part of the closed list)
+    BDD layer_states = closed.get_closed_at(g);
+    BDD domain = layer_states + terminal;
+    LayerCount layer{reached.counts * domain.Add(), reached.exponent};
+    if (has_zero_trs) {
+      add_zero_cost_paths(layer, domain, fw);
+    }
+
+    ADD terminal_counts = layer.counts * terminal_add;
+    layer.counts *= layer_states.Add();
+    PlanCount num_plans = sum(terminal_counts, layer.exponent);
+    if (!num_plans.is_zero()) {
+      result[g] = num_plans;
+    }
+
+    if (layer.counts == zero) {
+      continue;
+    }
+    normalize(layer);
+    layers[g] = layer;
+    for (const auto &trs_cost : trs) {
+      int cost = trs_cost.first;
+      if (cost > 0 && cost <= max_cost - g) {
+        costs.insert(g + cost);
+      }
+    }
+  }
+  return result;
+}
+} // namespace symbolic
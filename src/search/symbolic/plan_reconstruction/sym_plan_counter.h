@@ -0,0 +1,88 @@
+#ifndef SYMBOLIC_PLAN_RECONSTRUCTION_SYM_PLAN_COUNTER_H
+#define SYMBOLIC_PLAN_RECONSTRUCTION_SYM_PLAN_COUNTER_H
+
+#include "../sym_variables.h"
+#include "../transition_relation.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace symbolic {
+class ClosedList;
+
+/*
+ * Number of plans represented as value * 2^exponent.
+ * The exponent is only used if the value does not fit into a double
+ * (counts grow exponentially with the plan cost) and is the reason why
+ * huge counts are reported in log-space.
+ */
+class PlanCount {
+public:
+  double value;
+  int exponent;
+
+  PlanCount(double value = 0, int exponent = 0)
+      : value(value), exponent(exponent) {}
+
+  bool is_zero() const { return value == 0; }
+  bool is_infinite() const;
+  bool is_exact() const;
+  double log10() const;
+
+  friend std::ostream &operator<<(std::ostream &os, const PlanCount &count);
+};
+
+/*
+ * Counts the plans of each cost without enumerating them. The number of
+ * paths reaching a state is propagated as ADD through the closed layers
+ * of a unidirectional search by applying the individual TRs to the ADD
+ * of each layer. Thus, the runtime is polynomial in the size of the BDDs.
+ *
+ * Zero-cost layers: paths are extended with zero-cost steps within the
+ * states of the layer (and the terminal states) until a fixpoint is
+ * reached. States that are reachable from a zero-cost cycle are reached by
+ * infinitely many paths, so their counts (and those of the plans through
+ * them) are reported as infinite. Otherwise, the result is exact for all
+ * plans represented in the closed list, i.e., the optimal plans for sym-*
+ * and all plans up to the bound for symk-*.
+ */
+class SymPlanCounter {
+  std::shared_ptr<SymVariables> sym_vars;
+  std::map<int, std::vector<TransitionRelation>> trs;
+  ADD state_cube; // All (unprimed) variables to sum up all states
+
+  // Counts reaching each state of a closed layer: value * 2^exponent
+  struct LayerCount {
+    ADD counts;
+    int exponent;
+  };
+
+  ADD successors(const ADD &counts, const TransitionRelation &tr,
+                 bool fw) const;
+  ADD scale(const ADD &counts, int from_exponent, int to_exponent) const;
+  void normalize(LayerCount &layer) const;
+  BDD zero_cost_successors(const BDD &states, bool fw) const;
+  // Adds all paths of zero-cost steps within the domain to the layer
+  void add_zero_cost_paths(LayerCount &layer, const BDD &domain,
+                           bool fw) const;
+  PlanCount sum(const ADD &counts, int exponent) const;
+
+public:
+  SymPlanCounter(std::shared_ptr<SymVariables> sym_vars,
+                 const std::map<int, std::vector<TransitionRelation>> &trs);
+
+  /*
+   * Returns the number of plans of each cost up to max_cost.
+   * fw: the closed list belongs to a forward search, i.e. plans start
+   * in the start states of the closed list and end in terminal states.
+   * bw: layers are traversed with preimages and the terminal states are
+   * the initial states.
+   */
+  std::map<int, PlanCount> count_plans(const ClosedList &closed,
+                                       const BDD &terminal, bool fw,
+                                       int max_cost) const;
+};
+} // namespace symbolic
+
+#endif
@@ -1,6 +1,8 @@
 #include "sym_solution_registry.h"
 #include "../searches/uniform_cost_search.h"
 #include "../tasks/root_task.h"
+#include "../../utils/system.h"
+#include "sym_plan_counter.h"
 
 namespace symbolic {
 
@@ -16,15 +18,21 @@ BDD SymSolutionRegistry::get_resulting_state(const Plan &plan) const {
   return sym_vars->getStateBDD(cur);
 }
 
+bool SymSolutionRegistry::stop_extraction() const {
+  return plan_data_base->found_enough_plans() ||
+         (utils::is_cancellation_requested() &&
+          plan_data_base->get_num_reported_plan() > 0);
+}
+
 void SymSolutionRegistry::add_plan(const Plan &plan) const {
   plan_data_base->add_plan(plan);
-  if (!plan_data_base->found_enough_plans() && task_has_zero_costs() &&
+  if (!stop_extraction() && task_has_zero_costs() &&
       plan_data_base->has_zero_cost_loop(plan)) {
     std::pair<int, int> zero_cost_op_seq =
         plan_data_base->get_first_zero_cost_loop(plan);
     Plan cur_plan = plan;
     std::cout << " => zero cost loop detected =>" << std::flush;
-    while (!plan_data_base->found_enough_plans()) {
+    while (!stop_extraction()) {
       cur_plan.insert(cur_plan.begin() + zero_cost_op_seq.first,
                       plan.begin() + zero_cost_op_seq.first,
                       plan.begin() + zero_cost_op_seq.second + 1);
@@ -53,7 +61,7 @@ void SymSolutionRegistry::reconstruct_plans(const SymSolutionCut &cut) {
 
 void SymSolutionRegistry::extract_all_plans(SymSolutionCut &sym_cut, bool fw,
                                             Plan plan) {
-  if (plan_data_base->found_enough_plans()) {
+  if (stop_extraction()) {
     return;
   }
 
@@ -98,7 +106,7 @@ void SymSolutionRegistry::extract_all_zero_plans(SymSolutionCut &sym_cut,
           sym_cut.get_cut() * fw_search->getClosedShared()->get_start_states();
       if (!intersection.IsZero()) {
         add_plan(plan);
-        if (plan_data_base->found_enough_plans()) {
+        if (stop_extraction()) {
           return;
         }
       }
@@ -114,7 +122,7 @@ void SymSolutionRegistry::extract_all_zero_plans(SymSolutionCut &sym_cut,
                        bw_search->getClosedShared()->get_start_states();
         if (!intersection.IsZero()) {
           add_plan(plan);
-          if (plan_data_base->found_enough_plans()) {
+          if (stop_extraction()) {
             return;
           }
         }
@@ -128,7 +136,7 @@ void SymSolutionRegistry::extract_all_zero_plans(SymSolutionCut &sym_cut,
           sym_cut.get_cut() * bw_search->getClosedShared()->get_start_states();
       if (!intersection.IsZero()) {
         add_plan(plan);
-        if (plan_data_base->found_enough_plans()) {
+        if (stop_extraction()) {
           return;
         }
       }
@@ -191,7 +199,7 @@ bool SymSolutionRegistry::reconstruct_zero_action(
         SymSolutionCut new_cut(sym_cut.get_g(), sym_cut.get_h(), intersection);
         extract_all_plans(new_cut, fw, new_plan);
 
-        if (plan_data_base->found_enough_plans()) {
+        if (stop_extraction()) {
           return true;
         }
       }
@@ -232,7 +240,7 @@ bool SymSolutionRegistry::reconstruct_cost_action(
       }
       extract_all_plans(new_cut, fw, new_plan);
 
-      if (plan_data_base->found_enough_plans()) {
+      if (stop_extraction()) {
         return true;
       }
     }
@@ -295,7 +303,7 @@ void SymSolutionRegistry::construct_cheaper_solutions(int bound) {
   int min_plan_bound = std::numeric_limits<int>::max();
 
   while (sym_cuts.size() > 0 && sym_cuts.at(0).get_f() < bound &&
-         !found_all_plans()) {
+         !stop_extraction()) {
 
     // Ignore cuts with costs smaller than the proven cost bound
     // This occurs only in bidirectional search
@@ -314,4 +322,26 @@ void SymSolutionRegistry::construct_cheaper_solutions(int bound) {
     plan_cost_bound = min_plan_bound;
   }
 }
+
+void SymSolutionRegistry::print_plan_counts(int max_cost) const {
+  if (fw_search && bw_search) {
+    std::cout << "Plan counting is not supported for bidirectional search"
+              << std::endl;
+    return;
+  }
+  utils::Timer timer;
+  bool fw = fw_search != nullptr;
+  UniformCostSearch *search = fw ? fw_search : bw_search;
+  BDD terminal = fw ? search->getStateSpace()->getGoal()
+                    : search->getStateSpace()->getInitialState();
+
+  SymPlanCounter counter(sym_vars, trs);
+  std::map<int, PlanCount> counts =
+      counter.count_plans(*search->getClosedShared(), terminal, fw, max_cost);
+  for (const auto &count : counts) {
+    std::cout << "Number of plans with cost " << count.first << ": "
+              << count.second << std::endl;
+  }
+  std::cout << "Plan counting time: " << timer << std::endl;
+}
 } // namespace symbolic
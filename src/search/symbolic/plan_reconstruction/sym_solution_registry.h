@@ -34,6 +34,10 @@ protected:
 
   void add_plan(const Plan &plan) const;
 
+  // True once enough plans have been found, or some plan after a
+  // cancellation signal, which stops the enumeration of further plans
+  bool stop_extraction() const;
+
   // Extracts all plans by a DFS, we copy the current plan suffix by every
   // recusive call which is why we don't use any reference for plan
   // BID: After reconstruction of the forward part we reverse the plan and
@@ -62,6 +66,10 @@ public:
   void register_solution(const SymSolutionCut &solution);
   void construct_cheaper_solutions(int bound);
 
+  // Prints the number of plans for each cost up to max_cost
+  // (only unidirectional searches are supported)
+  void print_plan_counts(int max_cost) const;
+
   bool found_all_plans() const {
     return plan_data_base && plan_data_base->found_enough_plans();
   }
@@ -0,0 +1,235 @@
+#include "hybrid_symbolic_uniform_cost_search.h"
+
+#include "../../option_parser.h"
+#include "../../plugin.h"
+#include "../../task_utils/successor_generator.h"
+#include "../../task_utils/task_properties.h"
+#include "../closed_list.h"
+#include "../original_state_space.h"
+#include "../plan_selection/plan_database.h"
+#include "../searches/uniform_cost_search.h"
+#include "../sym_state_space_cache.h"
+#include "../sym_variables.h"
+
+#include <memory>
+
+using namespace std;
+
+namespace symbolic {
+
+HybridSymbolicUniformCostSearch::HybridSymbolicUniformCostSearch(
+    const options::Options &opts)
+    : SymbolicUniformCostSearch(opts, true, false),
+      max_explicit_open(opts.get<int>("max_explicit_open")),
+      zero_cost_depth(0), num_explicit_open(0) {}
+
+void HybridSymbolicUniformCostSearch::initialize() {
+  // The state space (and its TRs) is only created on the switch
+  SymbolicSearch::initialize();
+  if (plan_data_base->get_num_desired_plans() != 1) {
+    cerr << "Hybrid search only supports a single plan" << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+  }
+  plan_data_base->init(vars);
+
+  GlobalState initial_state = state_registry.get_initial_state();
+  SearchNode node = search_space.get_node(initial_state);
+  node.open_initial();
+  explicit_open[0].push_back(initial_state.get_id());
+  num_explicit_open = 1;
+}
+
+SearchStatus HybridSymbolicUniformCostSearch::step() {
+  if (search) {
+    return SymbolicSearch::step();
+  }
+  if (utils::is_cancellation_requested()) {
+    cout << "Search cancelled in the explicit phase" << endl;
+    return TIMEOUT;
+  }
+  if (num_explicit_open > max_explicit_open) {
+    switch_to_symbolic();
+    return IN_PROGRESS;
+  }
+  return explicit_step();
+}
+
+SearchStatus HybridSymbolicUniformCostSearch::explicit_step() {
+  // Fetch the open state with minimum g (skipping outdated entries)
+  StateID id = StateID::no_state;
+  int g = 0;
+  while (id == StateID::no_state && !explicit_open.empty()) {
+    auto bucket = explicit_open.begin();
+    g = bucket->first;
+    StateID candidate = bucket->second.front();
+    bucket->second.pop_front();
+    if (bucket->second.empty()) {
+      explicit_open.erase(bucket);
+    }
+    SearchNode node =
+        search_space.get_node(state_registry.lookup_state(candidate));
+    if (node.is_open() && node.get_g() == g) {
+      id = candidate;
+    }
+  }
+  if (id == StateID::no_state) {
+    cout << "Completely explored state space -- no solution!" << endl;
+    return FAILED;
+  }
+
+  GlobalState state = state_registry.lookup_state(id);
+  SearchNode node = search_space.get_node(state);
+  setLowerBound(g);
+  if (task_properties::is_goal_state(task_proxy, state)) {
+    Plan plan;
+    search_space.trace_path(state, plan);
+    plan_data_base->add_plan(plan);
+    solution_found = true;
+    cout << "Solution found in the explicit phase" << endl;
+    cout << "Best plan:" << endl;
+    plan_data_base->dump_first_accepted_plan();
+    return SOLVED;
+  }
+  node.close();
+  --num_explicit_open;
+  explicit_closed.push_back(id);
+  statistics.inc_expanded();
+
+  vector<OperatorID> applicable_ops;
+  successor_generator.generate_applicable_ops(state, applicable_ops);
+  for (OperatorID op_id : applicable_ops) {
+    OperatorProxy op = task_proxy.get_operators()[op_id];
+    GlobalState succ_state = state_registry.get_successor_state(state, op);
+    statistics.inc_generated();
+    SearchNode succ_node = search_space.get_node(succ_state);
+    int succ_g = g + op.get_cost();
+    if (succ_node.is_new()) {
+      succ_node.open(node, op, op.get_cost());
+      ++num_explicit_open;
+    } else if (succ_node.is_open() && succ_g < succ_node.get_g()) {
+      succ_node.reopen(node, op, op.get_cost());
+    } else {
+      continue;
+    }
+    zero_cost_depth[succ_state] =
+        op.get_cost() == 0 ? zero_cost_depth[state] + 1 : 0;
+    explicit_open[succ_g].push_back(succ_state.get_id());
+  }
+  return IN_PROGRESS;
+}
+
+BDD HybridSymbolicUniformCostSearch::get_state_bdd(
+    const GlobalState &state) const {
+  // Derived variables are not part of symbolic states
+  BDD res = vars->oneBDD();
+  const vector<int> &var_order = vars->get_var_order();
+  for (int i = var_order.size() - 1; i >= 0; i--) {
+    int var = var_order[i];
+    if (task_proxy.get_variables()[var].is_derived()) {
+      continue;
+    }
+    res *= vars->preBDD(var, state[var]);
+  }
+  return res;
+}
+
+BDD HybridSymbolicUniformCostSearch::get_states_bdd(
+    const vector<StateID> &states) const {
+  // Balanced disjunction, so that most disjunctions are on small BDDs
+  Bucket bdds;
+  bdds.reserve(states.size());
+  for (StateID id : states) {
+    bdds.push_back(get_state_bdd(state_registry.lookup_state(id)));
+  }
+  if (bdds.empty()) {
+    return vars->zeroBDD();
+  }
+  while (bdds.size() > 1) {
+    size_t num_merged = (bdds.size() + 1) / 2;
+    for (size_t i = 0; i < num_merged; ++i) {
+      bdds[i] = 2 * i + 1 < bdds.size() ? bdds[2 * i] + bdds[2 * i + 1]
+                                        : bdds[2 * i];
+    }
+    bdds.resize(num_merged);
+  }
+  return bdds[0];
+}
+
+void HybridSymbolicUniformCostSearch::switch_to_symbolic() {
+  utils::Timer timer;
+  mgr = get_cached_original_state_space(vars.get(), mgrParams);
+  double tr_time = timer();
+
+  // Closed states by g and zero-cost depth
+  map<int, map<int, vector<StateID>>> closed_states;
+  for (StateID id : explicit_closed) {
+    GlobalState state = state_registry.lookup_state(id);
+    int g = search_space.get_node(state).get_g();
+    closed_states[g][zero_cost_depth[state]].push_back(id);
+  }
+  map<int, Bucket> closed_layers;
+  for (auto &layer : closed_states) {
+    for (auto &sublayer : layer.second) {
+      closed_layers[layer.first].push_back(get_states_bdd(sublayer.second));
+    }
+  }
+
+  map<int, BDD> open_states;
+  int num_open = 0;
+  for (auto &bucket : explicit_open) {
+    vector<StateID> states;
+    for (StateID id : bucket.second) {
+      SearchNode node = search_space.get_node(state_registry.lookup_state(id));
+      if (node.is_open() && node.get_g() == bucket.first) {
+        states.push_back(id);
+      }
+    }
+    num_open += states.size();
+    open_states[bucket.first] = get_states_bdd(states);
+  }
+  cout << "Switching to symbolic search after " << explicit_closed.size()
+       << " expansions: " << num_open << " open states, TRs: " << tr_time
+       << "s, conversion: " << timer() - tr_time << "s" << endl;
+
+  map<int, deque<StateID>>().swap(explicit_open);
+  vector<StateID>().swap(explicit_closed);
+
+  unique_ptr<UniformCostSearch> fw_search =
+      unique_ptr<UniformCostSearch>(new UniformCostSearch(this, searchParams));
+  if (use_relays(false)) {
+    fw_search->getClosedShared()->set_relays(searchParams.relay_interval, true);
+  }
+  fw_search->init(mgr, true, nullptr, closed_layers, open_states);
+  solution_registry.init(vars, fw_search.get(), nullptr, plan_data_base,
+                         true);
+  search = move(fw_search);
+}
+
+} // namespace symbolic
+
+static shared_ptr<SearchEngine> _parse_hybrid_ucs(OptionParser &parser) {
+  parser.document_synopsis(
+      "Hybrid Explicit/Symbolic Forward Uniform Cost Search",
+      "Explicit uniform cost search that switches to symbolic search when "
+      "the open list exceeds max_explicit_open states. Only one plan is "
+      "found.");
+  symbolic::SymbolicSearch::add_options_to_parser(parser);
+  parser.add_option<shared_ptr<symbolic::PlanDataBase>>(
+      "plan_selection", "plan selection strategy", "top_k(num_plans=1)");
+  parser.add_option<int>("max_explicit_open",
+                         "number of open states of the explicit search at "
+                         "which it switches to symbolic search",
+                         "100000", Bounds("0", "infinity"));
+  Options opts = parser.parse();
+
+  shared_ptr<symbolic::SymbolicSearch> engine = nullptr;
+  if (!parser.dry_run()) {
+    engine = make_shared<symbolic::HybridSymbolicUniformCostSearch>(opts);
+    cout << "Hybrid Explicit/Symbolic Forward Uniform Cost Search" << endl;
+  }
+
+  return engine;
+}
+
+static Plugin<SearchEngine> _plugin_sym_hybrid_fw("sym-hybrid-fw",
+                                                  _parse_hybrid_ucs);
@@ -0,0 +1,52 @@
+#ifndef SYMBOLIC_SEARCH_ENGINES_HYBRID_SYMBOLIC_UNIFORM_COST_SEARCH_H
+#define SYMBOLIC_SEARCH_ENGINES_HYBRID_SYMBOLIC_UNIFORM_COST_SEARCH_H
+
+#include "symbolic_uniform_cost_search.h"
+
+#include "../../per_state_information.h"
+
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace symbolic {
+/*
+ * Forward uniform cost search that starts explicitly and continues
+ * symbolically once the open list exceeds max_explicit_open states. Tasks
+ * that are solved before never build the transition relations.
+ *
+ * On the switch, the closed states become the closed layers of a
+ * UniformCostSearch (states closed with the same g and reached by zero-cost
+ * operators in order of their zero-cost depth, like the sublayers of a
+ * symbolic fixpoint) and the open states its open list. Thus, the plan
+ * reconstruction of the symbolic search also traces the explicit prefix.
+ */
+class HybridSymbolicUniformCostSearch : public SymbolicUniformCostSearch {
+  int max_explicit_open;
+
+  // Explicit phase: open states by g (stale entries are skipped), closed
+  // states in expansion order and number of zero-cost operators since the
+  // last cost operator on the path of each state
+  std::map<int, std::deque<StateID>> explicit_open;
+  std::vector<StateID> explicit_closed;
+  PerStateInformation<int> zero_cost_depth;
+  int num_explicit_open;
+
+  SearchStatus explicit_step();
+  void switch_to_symbolic();
+  BDD get_state_bdd(const GlobalState &state) const;
+  BDD get_states_bdd(const std::vector<StateID> &states) const;
+
+protected:
+  virtual void initialize() override;
+
+  virtual SearchStatus step() override;
+
+public:
+  HybridSymbolicUniformCostSearch(const options::Options &opts);
+  virtual ~HybridSymbolicUniformCostSearch() = default;
+};
+
+} // namespace symbolic
+
+#endif
@@ -1,15 +1,18 @@
 #include "osp_symbolic_uniform_cost_search.h"
 #include "../../option_parser.h"
+#include "../closed_list.h"
 #include "../../plugin.h"
 #include "../original_state_space.h"
 #include "../searches/bidirectional_search.h"
 #include "../searches/osp_uniform_cost_search.h"
+#include "../sym_state_space_cache.h"
+#include "../../utils/system.h"
 
 namespace symbolic {
 
 void OspSymbolicUniformCostSearch::initialize() {
   SymbolicSearch::initialize();
-  mgr = std::make_shared<OriginalStateSpace>(vars.get(), mgrParams);
+  mgr = get_cached_original_state_space(vars.get(), mgrParams);
 
   std::unique_ptr<OspUniformCostSearch> fw_search = nullptr;
   std::unique_ptr<OspUniformCostSearch> bw_search = nullptr;
@@ -24,6 +27,12 @@ void OspSymbolicUniformCostSearch::initialize() {
         new OspUniformCostSearch(this, searchParams));
   }
 
+  if (use_relays(fw && bw)) {
+    (fw ? fw_search : bw_search)
+        ->getClosedShared()
+        ->set_relays(searchParams.relay_interval, fw);
+  }
+
   if (fw) {
     fw_search->init(mgr, true, bw_search.get());
   }
@@ -44,7 +53,9 @@ void OspSymbolicUniformCostSearch::initialize() {
   }
 
   initialize_utilitiy_function();
-  upper_bound = task->get_plan_bound(); // We use upper bound for plan bound
+  // We use upper bound for plan bound. The bound option allows to change it
+  // without another task, e.g., between the requests of the planner service.
+  upper_bound = std::min(task->get_plan_bound(), bound);
 }
 
 void OspSymbolicUniformCostSearch::initialize_utilitiy_function() {
@@ -92,6 +103,14 @@ void OspSymbolicUniformCostSearch::initialize_utilitiy_function() {
 }
 
 SearchStatus OspSymbolicUniformCostSearch::step() {
+  if (utils::is_cancellation_requested()) {
+    SearchStatus status =
+        finish_cancelled_search(std::numeric_limits<int>::max());
+    if (solution_found) {
+      std::cout << "Plan utility: " << plan_utility << std::endl;
+    }
+    return status;
+  }
   step_num++;
   // Handling empty plan
   if (step_num == 0) {
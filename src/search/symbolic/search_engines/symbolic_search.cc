@@ -10,10 +10,21 @@
 #include "../searches/uniform_cost_search.h"
 
 #include "../sym_params_search.h"
+#include "../sym_state_space_cache.h"
 #include "../sym_state_space_manager.h"
+#include "../sym_utils.h"
 #include "../sym_variables.h"
+#include "../transition_relation.h"
 
 #include "../task_utils/task_properties.h"
+#include "../../utils/hash.h"
+#include "../../utils/memory.h"
+#include "../../utils/system.h"
+
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
 
 using namespace std;
 using namespace symbolic;
@@ -21,28 +32,113 @@ using namespace options;
 
 namespace symbolic {
 
+static const int PROFILE_VERSION = 1;
+
+static void feed_string(utils::HashState &hash_state, const string &str) {
+  utils::feed(hash_state, static_cast<int>(str.size()));
+  for (char c : str) {
+    utils::feed(hash_state, static_cast<int>(c));
+  }
+}
+
+// Identifies the task: variables, operators, initial state and goal
+static uint64_t compute_task_key(const TaskProxy &task_proxy) {
+  utils::HashState hash_state;
+  for (VariableProxy var : task_proxy.get_variables()) {
+    utils::feed(hash_state, var.get_domain_size());
+  }
+  for (OperatorProxy op : task_proxy.get_operators()) {
+    feed_string(hash_state, op.get_name());
+    utils::feed(hash_state, op.get_cost());
+  }
+  for (FactProxy fact : task_proxy.get_initial_state()) {
+    utils::feed(hash_state, fact.get_value());
+  }
+  for (FactProxy fact : task_proxy.get_goals()) {
+    utils::feed(hash_state, fact.get_pair().var);
+    utils::feed(hash_state, fact.get_pair().value);
+  }
+  return hash_state.get_hash64();
+}
+
+// Identifies the domain by the names of its action schemas, i.e., the first
+// word of the operator names
+static uint64_t compute_domain_key(const TaskProxy &task_proxy) {
+  set<string> schemas;
+  for (OperatorProxy op : task_proxy.get_operators()) {
+    const string &name = op.get_name();
+    schemas.insert(name.substr(0, name.find(' ')));
+  }
+  utils::HashState hash_state;
+  for (const string &schema : schemas) {
+    feed_string(hash_state, schema);
+  }
+  return hash_state.get_hash64();
+}
+
 SymbolicSearch::SymbolicSearch(const options::Options &opts)
-    : SearchEngine(opts), vars(make_shared<SymVariables>(opts)),
+    : SearchEngine(opts), vars(get_cached_variables(opts)),
       mgrParams(opts), searchParams(opts), step_num(-1),
       lower_bound_increased(true), lower_bound(0),
       upper_bound(std::numeric_limits<int>::max()), min_g(0),
       plan_data_base(opts.get<std::shared_ptr<PlanDataBase>>("plan_selection")),
-      solution_registry() {
+      solution_registry(), count_plans(opts.get<bool>("count_plans")) {
   save_plans = false; // we handle plans seperat
+  if (opts.contains("trace_file")) {
+    trace = utils::make_unique_ptr<SymTrace>(opts.get<string>("trace_file"));
+  }
+  if (opts.contains("profile")) {
+    profile_file = opts.get<string>("profile");
+  }
   mgrParams.print_options();
   searchParams.print_options();
-  vars->init();
 }
 
 void SymbolicSearch::initialize() {
   plan_data_base->set_plan_manager(get_plan_manager());
   plan_data_base->print_options();
+  utils::register_cancellation_handlers();
+}
+
+bool SymbolicSearch::use_relays(bool bidirectional) const {
+  if (searchParams.relay_interval == 0) {
+    return false;
+  }
+  if (bidirectional || count_plans ||
+      plan_data_base->get_num_desired_plans() != 1) {
+    cout << "Relay layers are only used by unidirectional searches for a "
+            "single plan without plan counting: keeping all closed layers"
+         << endl;
+    return false;
+  }
+  return true;
+}
+
+SearchStatus SymbolicSearch::finish_cancelled_search(int bound) {
+  cout << "Search cancelled at bound " << lower_bound
+       << ": reconstructing the solutions found so far" << endl;
+  // Plans reported before the cancellation are enough
+  if (plan_data_base->get_num_reported_plan() == 0) {
+    solution_registry.construct_cheaper_solutions(bound);
+  }
+  solution_found = plan_data_base->get_num_reported_plan() > 0;
+  if (solution_found) {
+    cout << "Best plan:" << endl;
+    plan_data_base->dump_first_accepted_plan();
+  }
+  return TIMEOUT;
 }
 
 SearchStatus SymbolicSearch::step() {
+  if (utils::is_cancellation_requested()) {
+    return finish_cancelled_search(numeric_limits<int>::max());
+  }
   step_num++;
   // Handling empty plan
   if (step_num == 0) {
+    if (!profile_file.empty()) {
+      load_profile();
+    }
     BDD cut = mgr->getInitialState() * mgr->getGoal();
     if (!cut.IsZero()) {
       new_solution(SymSolutionCut(0, 0, cut));
@@ -111,11 +207,141 @@ void SymbolicSearch::new_solution(const SymSolutionCut &sol) {
   }
 }
 
+void SymbolicSearch::print_statistics() const {
+  SearchEngine::print_statistics();
+  cout << "Symbolic steps: " << step_num + 1 << endl;
+  if (mgr) {
+    mgr->print_filter_statistics();
+  }
+  if (count_plans) {
+    solution_registry.print_plan_counts(std::min(lower_bound, upper_bound));
+  }
+  if (trace) {
+    trace->flush();
+  }
+  if (!profile_file.empty() && search) {
+    save_profile();
+  }
+  if (vars->get_memory_timeline()) {
+    print_memory_statistics();
+  }
+}
+
+void SymbolicSearch::load_profile() {
+  ifstream file(profile_file);
+  if (!file) {
+    cout << "No search profile in " << profile_file << endl;
+    return;
+  }
+  int version = -1;
+  string task_key, domain_key;
+  string line;
+  if (getline(file, line)) {
+    version = getData<int>(line, " ", "");
+  }
+  if (getline(file, line)) {
+    task_key = getData<string>(line, " ", "");
+  }
+  if (getline(file, line)) {
+    domain_key = getData<string>(line, " ", "");
+  }
+  if (version != PROFILE_VERSION) {
+    cout << "Ignoring search profile " << profile_file
+         << ": unsupported version" << endl;
+    return;
+  }
+
+  ostringstream key;
+  key << hex << compute_task_key(task_proxy);
+  string match;
+  if (task_key == key.str()) {
+    match = "same task";
+  } else {
+    key.str("");
+    key << hex << compute_domain_key(task_proxy);
+    if (domain_key != key.str()) {
+      cout << "Ignoring search profile " << profile_file
+           << ": different domain" << endl;
+      return;
+    }
+    match = "same domain";
+  }
+
+  stringstream profile;
+  profile << file.rdbuf();
+  if (search->read_profile(profile.str())) {
+    cout << "Loaded search profile from " << profile_file << " (" << match
+         << ")" << endl;
+  } else {
+    cout << "Search profile " << profile_file
+         << " has no data for the search directions" << endl;
+  }
+}
+
+void SymbolicSearch::save_profile() const {
+  ofstream file(profile_file);
+  if (!file) {
+    cerr << "Warning: could not write search profile " << profile_file
+         << endl;
+    return;
+  }
+  file << "version " << PROFILE_VERSION << endl;
+  file << "task " << hex << compute_task_key(task_proxy) << endl;
+  file << "domain " << compute_domain_key(task_proxy) << dec << endl;
+  search->write_profile(file);
+  cout << "Saved search profile to " << profile_file << endl;
+}
+
+void SymbolicSearch::print_memory_statistics() const {
+  Bucket closed_bdds, open_bdds, tr_bdds;
+  if (search) {
+    search->getBDDs(closed_bdds, open_bdds);
+  }
+  if (mgr) {
+    for (const auto &trs : mgr->getTransitions()) {
+      for (const TransitionRelation &tr : trs.second) {
+        tr_bdds.push_back(tr.getBDD());
+      }
+    }
+    for (const auto &trs : mgr->getIndividualTRs()) {
+      for (const TransitionRelation &tr : trs.second) {
+        tr_bdds.push_back(tr.getBDD());
+      }
+    }
+  }
+
+  SymMemoryTimeline *timeline = vars->get_memory_timeline();
+  timeline->print_timeline();
+  timeline->print_summary({{"closed list", closed_bdds},
+                           {"open list", open_bdds},
+                           {"transition relations", tr_bdds}});
+  if (search) {
+    search->print_layer_memory();
+  }
+}
+
 void SymbolicSearch::add_options_to_parser(OptionParser &parser) {
   SearchEngine::add_options_to_parser(parser);
   SymVariables::add_options_to_parser(parser);
   SymParamsSearch::add_options_to_parser(parser, 30e3, 10e7);
   SymParamsMgr::add_options_to_parser(parser);
   PlanDataBase::add_options_to_parser(parser);
+  parser.add_option<bool>(
+      "count_plans",
+      "count the plans per cost (up to the proven bound) after the search "
+      "by propagating path counts through the closed list",
+      "false");
+  parser.add_option<string>(
+      "trace_file",
+      "write one JSON record per search step to this file (disabled if not "
+      "given)",
+      OptionParser::NONE);
+  parser.add_option<string>(
+      "profile",
+      "warm-start the step-cost estimations and step size limits of the "
+      "search directions from this file if it was written for the same task "
+      "or domain, and save the ones of this run to it at exit (disabled if "
+      "not given)",
+      OptionParser::NONE);
 }
 } // namespace symbolic
@@ -2,6 +2,7 @@
 #define SYMBOLIC_SEARCH_ENGINES_SYMBOLIC_SEARCH_H
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "../../option_parser.h"
@@ -10,6 +11,7 @@
 #include "../sym_enums.h"
 #include "../sym_params_search.h"
 #include "../sym_state_space_manager.h"
+#include "../sym_trace.h"
 
 namespace options {
 class Options;
@@ -42,11 +44,33 @@ protected:
 
   std::shared_ptr<PlanDataBase> plan_data_base;
   SymSolutionRegistry solution_registry; // Solution registry
-  
+
+  bool count_plans; // Count the plans per cost after the search
+
+  std::unique_ptr<SymTrace> trace; // Only set if a trace file is given
+
+  // Step-cost estimations of a previous run of the same task or domain are
+  // loaded before the first step and this run's are saved at exit (empty if
+  // no profile is used)
+  std::string profile_file;
+  void load_profile();
+  void save_profile() const;
+
   virtual void initialize() override;
 
   virtual SearchStatus step() override;
 
+  // Reconstructs the plans of the solutions found so far with cost below the
+  // bound, which need not be optimal, after a cancellation signal (see
+  // utils::register_cancellation_handlers). It stops after the first plan,
+  // or at once if some plan was already reported, since after a SIGXCPU the
+  // process is killed about one second later.
+  SearchStatus finish_cancelled_search(int bound);
+
+  // True if the closed list of the search only needs to keep the relay
+  // layers for plan reconstruction (see ClosedList::set_relays)
+  bool use_relays(bool bidirectional) const;
+
 public:
   SymbolicSearch(const options::Options &opts);
   virtual ~SymbolicSearch() = default;
@@ -61,12 +85,22 @@ public:
 
   virtual int getMinG() const { return min_g; }
 
+  // Solutions with cost >= upper bound are not needed (max for top-k)
+  virtual int getUpperBound() const { return upper_bound; }
+
   virtual BDD get_states_on_goal_paths() const {
     return solution_registry.get_states_on_goal_paths();
   }
 
   virtual void new_solution(const SymSolutionCut &sol);
 
+  SymTrace *get_trace() const { return trace.get(); }
+
+  virtual void print_statistics() const override;
+
+  // Memory of the CUDD manager and BDD nodes per data structure
+  void print_memory_statistics() const;
+
   static void add_options_to_parser(OptionParser &parser);
 };
 
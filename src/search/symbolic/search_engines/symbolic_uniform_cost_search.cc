@@ -1,9 +1,11 @@
 #include "symbolic_uniform_cost_search.h"
 #include "../../option_parser.h"
+#include "../closed_list.h"
 #include "../original_state_space.h"
 #include "../plugin.h"
 #include "../searches/bidirectional_search.h"
 #include "../searches/uniform_cost_search.h"
+#include "../sym_state_space_cache.h"
 
 #include <memory>
 
@@ -11,7 +13,7 @@ namespace symbolic {
 
 void SymbolicUniformCostSearch::initialize() {
   SymbolicSearch::initialize();
-  mgr = std::make_shared<OriginalStateSpace>(vars.get(), mgrParams);
+  mgr = get_cached_original_state_space(vars.get(), mgrParams);
 
   std::unique_ptr<UniformCostSearch> fw_search = nullptr;
   std::unique_ptr<UniformCostSearch> bw_search = nullptr;
@@ -26,6 +28,12 @@ void SymbolicUniformCostSearch::initialize() {
         new UniformCostSearch(this, searchParams));
   }
 
+  if (use_relays(fw && bw)) {
+    (fw ? fw_search : bw_search)
+        ->getClosedShared()
+        ->set_relays(searchParams.relay_interval, fw);
+  }
+
   if (fw) {
     fw_search->init(mgr, true, bw_search.get());
   }
@@ -4,6 +4,7 @@
 #include "../plugin.h"
 #include "../searches/bidirectional_search.h"
 #include "../searches/top_k_uniform_cost_search.h"
+#include "../sym_state_space_cache.h"
 
 #include <memory>
 
@@ -12,7 +13,7 @@ namespace symbolic {
 void TopkSymbolicUniformCostSearch::initialize() {
   SymbolicSearch::initialize();
 
-  mgr = std::make_shared<OriginalStateSpace>(vars.get(), mgrParams);
+  mgr = get_cached_original_state_space(vars.get(), mgrParams);
 
   std::unique_ptr<TopkUniformCostSearch> fw_search = nullptr;
   std::unique_ptr<TopkUniformCostSearch> bw_search = nullptr;
@@ -4,6 +4,7 @@
 #include "../plugin.h"
 #include "../searches/bidirectional_search.h"
 #include "../searches/top_k_uniform_cost_search.h"
+#include "../../utils/system.h"
 
 #include <memory>
 
@@ -30,6 +31,9 @@ void TopqSymbolicUniformCostSearch::new_solution(const SymSolutionCut &sol) {
 }
 
 SearchStatus TopqSymbolicUniformCostSearch::step() {
+  if (utils::is_cancellation_requested()) {
+    return finish_cancelled_search(upper_bound);
+  }
   step_num++;
   // Handling empty plan
   if (step_num == 0) {
@@ -29,6 +29,16 @@ UniformCostSearch *BidirectionalSearch::selectBestDirection() const {
   }
   // std::cout << (fw->nextStepNodes() <= bw->nextStepNodes() ? "fwd " : "bwd ")
   // << std::flush;
+  if (p.direction_selection != DirectionSelection::NODES) {
+    bool lookahead =
+        p.direction_selection == DirectionSelection::TIME_LOOKAHEAD;
+    double fw_time = fw->predictedStepTime(lookahead);
+    double bw_time = bw->predictedStepTime(lookahead);
+    // Ties (e.g., before any step was measured) are broken by nodes
+    if (fw_time != bw_time) {
+      return fw_time < bw_time ? fw.get() : bw.get();
+    }
+  }
   return fw->nextStepNodes() <= bw->nextStepNodes() ? fw.get() : bw.get();
 }
 
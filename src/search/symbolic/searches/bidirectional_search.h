@@ -45,6 +45,27 @@ public:
     return std::min<int>(fw->nextStepNodesResult(), bw->nextStepNodesResult());
   }
 
+  virtual void getBDDs(Bucket &closed_bdds, Bucket &open_bdds) const override {
+    fw->getBDDs(closed_bdds, open_bdds);
+    bw->getBDDs(closed_bdds, open_bdds);
+  }
+
+  virtual void print_layer_memory() const override {
+    fw->print_layer_memory();
+    bw->print_layer_memory();
+  }
+
+  virtual void write_profile(std::ostream &file) const override {
+    fw->write_profile(file);
+    bw->write_profile(file);
+  }
+
+  virtual bool read_profile(const std::string &profile) override {
+    bool read_fw = fw->read_profile(profile);
+    bool read_bw = bw->read_profile(profile);
+    return read_fw || read_bw;
+  }
+
   bool isExpFor(BidirectionalSearch *bdExp) const;
 
   inline UniformCostSearch *getFw() const { return fw.get(); }
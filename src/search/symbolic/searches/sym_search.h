@@ -5,8 +5,10 @@
 #include "../sym_params_search.h"
 #include "../sym_state_space_manager.h"
 #include "../sym_utils.h"
+#include <iostream>
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace symbolic {
@@ -52,6 +54,19 @@ public:
   virtual long nextStepNodesResult() const = 0;
 
   virtual bool isSearchableWithNodes(int maxNodes) const = 0;
+
+  // Appends the BDDs of the closed and open lists (memory statistics)
+  virtual void getBDDs(Bucket & /*closed_bdds*/,
+                       Bucket & /*open_bdds*/) const {}
+
+  // Prints the memory held by each closed layer
+  virtual void print_layer_memory() const {}
+
+  // Step-cost estimations learned by each direction (warm start of later
+  // runs, see SymbolicSearch::save_profile). read_profile returns whether
+  // the profile had data for this search.
+  virtual void write_profile(std::ostream & /*file*/) const {}
+  virtual bool read_profile(const std::string & /*profile*/) { return false; }
 };
 } // namespace symbolic
 #endif // SYMBOLIC_SEARCH
\ No newline at end of file
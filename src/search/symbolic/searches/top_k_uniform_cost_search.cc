@@ -11,9 +11,8 @@ bool TopkUniformCostSearch::provable_no_more_plans() {
   // Here last_g_cost corresponds to the current g-value of the
   // search dir. Thus we consider all smaller
   if (getG() > last_g_cost) {
-    BDD no_goal_path_states = !engine->get_states_on_goal_paths();
-    no_goal_path_states *= closed->getPartialClosed(last_g_cost - 1);
-    if (!open_list.contains_any_state(!no_goal_path_states)) {
+    update_dead_states();
+    if (!open_list.contains_state_outside(dead_states)) {
       return true; // Search finished
     }
   }
@@ -22,20 +21,39 @@ bool TopkUniformCostSearch::provable_no_more_plans() {
   return open_list.empty();
 }
 
+void TopkUniformCostSearch::update_dead_states() {
+  BDD goal_paths = engine->get_states_on_goal_paths();
+  if (dead_closed_h == std::numeric_limits<int>::min()) {
+    dead_states = mgr->zeroBDD();
+    dead_goal_paths = goal_paths;
+    dead_closed_h = -1;
+  } else if (goal_paths != dead_goal_paths) {
+    // New accepted plans: dead states shrink, so open is checked again
+    dead_states *= !goal_paths;
+    dead_goal_paths = goal_paths;
+    open_list.reset_containment();
+  }
+
+  // Layers below the current g are complete
+  if (last_g_cost - 1 > dead_closed_h) {
+    dead_states += closed->getClosedBetween(dead_closed_h + 1, last_g_cost - 1) *
+                   !goal_paths;
+    dead_closed_h = last_g_cost - 1;
+  }
+}
+
 void TopkUniformCostSearch::checkFrontierCut(Bucket &bucket, int g) {
   for (BDD &bucketBDD : bucket) {
-    auto all_sols =
-        perfectHeuristic->getAllCuts(bucketBDD, g, fw, engine->getMinG());
+    auto all_sols = perfectHeuristic->getAllCuts(
+        bucketBDD, g, fw, engine->getMinG(), engine->getUpperBound());
     for (auto &sol : all_sols) {
       engine->new_solution(sol);
     }
   }
 }
 
-void TopkUniformCostSearch::filterFrontier() {
-  frontier.filter(closed->get_closed_at(frontier.g()));
-  mgr->filterMutex(frontier.bucket(), fw, initialization());
-  removeZero(frontier.bucket());
+BDD TopkUniformCostSearch::frontierClosed() const {
+  return closed->get_closed_at(frontier.g());
 }
 
 } // namespace symbolic
\ No newline at end of file
@@ -3,18 +3,30 @@
 
 #include "uniform_cost_search.h"
 
+#include <limits>
+
 namespace symbolic {
 class TopkUniformCostSearch : public UniformCostSearch {
+  // States closed with h <= dead_closed_h that are not on an accepted goal
+  // path, maintained incrementally as layers are closed and plans accepted.
+  // Accepted goal paths only grow, so new plans only remove states.
+  BDD dead_states;
+  BDD dead_goal_paths; // Goal paths already removed from dead_states
+  int dead_closed_h;   // min int if not initialized yet
+
+  void update_dead_states();
+
 protected:
   virtual bool provable_no_more_plans() override;
 
   virtual void checkFrontierCut(Bucket &bucket, int g) override;
 
-  virtual void filterFrontier() override;
+  virtual BDD frontierClosed() const override;
 
 public:
   TopkUniformCostSearch(SymbolicSearch *eng, const SymParamsSearch &params)
-      : UniformCostSearch(eng, params) {}
+      : UniformCostSearch(eng, params),
+        dead_closed_h(std::numeric_limits<int>::min()) {}
 };
 } // namespace symbolic
 
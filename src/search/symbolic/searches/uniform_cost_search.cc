@@ -4,6 +4,7 @@
 #include "../frontier.h"
 #include "../plan_reconstruction/sym_solution_cut.h"
 #include "../search_engines/symbolic_search.h"
+#include "../sym_trace.h"
 #include "../sym_utils.h"
 #include "../utils/timer.h"
 
@@ -18,27 +19,58 @@ using utils::Timer;
 
 namespace symbolic {
 
+// Weight of the last step in the running average of time_correction
+static const double TIME_CORRECTION_WEIGHT = 0.3;
+
 UniformCostSearch::UniformCostSearch(SymbolicSearch *eng,
                                      const SymParamsSearch &params)
     : SymSearch(eng, params), fw(true), closed(std::make_shared<ClosedList>()),
-      estimationCost(params), estimationZero(params), lastStepCost(true) {}
+      estimationCost(params), estimationZero(params), lastStepCost(true),
+      time_correction(1.0) {
+  closed->set_delta_layers(params.delta_closed_layers);
+}
 
 bool UniformCostSearch::init(std::shared_ptr<SymStateSpaceManager> manager,
                              bool forward, UniformCostSearch *opposite_search) {
+  BDD init_bdd = forward ? manager->getInitialState() : manager->getGoal();
+  lastStepCost = true;
+  frontier.init(manager.get(), init_bdd);
+  closed->init(manager.get());
+  closed->insert(0, init_bdd);
+  return init_search(manager, forward, opposite_search);
+}
+
+bool UniformCostSearch::init(std::shared_ptr<SymStateSpaceManager> manager,
+                             bool forward, UniformCostSearch *opposite_search,
+                             const map<int, Bucket> &closed_layers,
+                             const map<int, BDD> &open_states) {
+  // The popped buckets are closed as in any later step
+  lastStepCost = false;
+  frontier.init(manager.get());
+  closed->init(manager.get());
+  for (const auto &layer : closed_layers) {
+    for (const BDD &states : layer.second) {
+      closed->insert(layer.first, states);
+    }
+  }
+  for (const auto &entry : open_states) {
+    open_list.insert(entry.second, entry.first);
+  }
+  return init_search(manager, forward, opposite_search);
+}
+
+bool UniformCostSearch::init_search(
+    std::shared_ptr<SymStateSpaceManager> manager, bool forward,
+    UniformCostSearch *opposite_search) {
   mgr = manager;
   fw = forward;
-  lastStepCost = true;
   last_g_cost = 0;
   assert(mgr);
 
-  BDD init_bdd = fw ? mgr->getInitialState() : mgr->getGoal();
-  frontier.init(manager.get(), init_bdd);
-
-  closed->init(mgr.get());
-  closed->insert(0, init_bdd);
-
   if (opposite_search) {
     perfectHeuristic = opposite_search->getClosedShared();
+    // Queried for cuts after each step
+    perfectHeuristic->enable_cumulative_sets();
   } else {
     perfectHeuristic = make_shared<ClosedList>();
     perfectHeuristic->init(mgr.get());
@@ -112,28 +144,48 @@ void UniformCostSearch::prepareBucket() {
   int maxTime = p.getAllotedTime(nextStepTime());
   int maxNodes = p.getAllotedNodes(nextStepNodesResult());
 
+  // Only trace if the bucket still needs to be filtered or merged
+  bool traced = engine->get_trace() && !frontier.expansionReady();
+  long bucket_nodes = traced ? frontier.nodes() : 0;
   Result res = frontier.prepare(maxTime, maxNodes, fw, initialization());
   if (!res.ok) {
     violated(res.truncated_reason, res.time_spent, maxTime, maxNodes);
   }
+  if (traced) {
+    trace_step("prepare", frontier.g(), bucket_nodes, res, nullptr,
+               Estimation(), frontier.nodes(), vector<ImageStats>(),
+               res.time_spent);
+  }
 }
 
 // Here we filter states: remove closed states and mutex states
 // This procedure is delayed in comparision to explicit search
 // Idea: no need to "change" BDDs until we actually process them
+BDD UniformCostSearch::frontierClosed() const { return !closed->notClosed(); }
+
 void UniformCostSearch::filterFrontier() {
-  frontier.filter(!closed->notClosed());
-  mgr->filterMutex(frontier.bucket(), fw, initialization());
-  removeZero(frontier.bucket());
+  frontier.filter(frontierClosed());
+  frontier.filter_mutex(fw, initialization());
 }
 
 bool UniformCostSearch::stepImage(int maxTime, int maxNodes) {
   Timer sTime;
+  SymTrace *trace = engine->get_trace();
+  vector<ImageStats> image_stats;
+  if (trace) {
+    mgr->set_image_stats(&image_stats);
+  }
+  int g = frontier.g();
   Result prepare_res =
       frontier.prepare(maxTime, maxNodes, fw, initialization());
   if (!prepare_res.ok) {
     violated(prepare_res.truncated_reason, prepare_res.time_spent, maxTime,
              maxNodes);
+    if (trace) {
+      mgr->set_image_stats(nullptr);
+      trace_step("step", g, frontier.nodes(), prepare_res, nullptr,
+                 Estimation(), 0, image_stats, sTime());
+    }
 
     if (sTime() * 1000.0 > p.maxStepTime) {
       double ratio = (double)p.maxStepTime / ((double)sTime() * 1000.0);
@@ -147,10 +199,31 @@ bool UniformCostSearch::stepImage(int maxTime, int maxNodes) {
   }
 
   int stepNodes = frontier.nodes();
-  ResultExpansion res_expansion = frontier.expand(maxTime, maxNodes, fw);
+  long frontier_nodes = stepNodes;
+  double estimated_time = nextStepTime();
+  Estimation estimation;
+  if (trace) {
+    const SymStepCostEstimation &est =
+        frontier.nextStepZero() ? estimationZero : estimationCost;
+    estimation = Estimation(est.time(), est.nodes());
+  }
+  ResultExpansion res_expansion = frontier.expand(
+      maxTime, maxNodes, fw, frontierClosed(), initialization());
 
   if (res_expansion.ok) {
     lastStepCost = false; // Must be set to false before calling checkCut
+    // Zero-cost layers of a fixpoint expansion are closed as sublayers so
+    // that each state has a predecessor in a previous sublayer. The cut
+    // check is done on a copy because pruned states may be predecessors of
+    // other layers.
+    if (!res_expansion.zero_layers.empty()) {
+      Bucket cut_layers = res_expansion.zero_layers;
+      checkFrontierCut(cut_layers, frontier.g());
+      for (const BDD &layer : res_expansion.zero_layers) {
+        stepNodes = max(stepNodes, layer.nodeCount());
+        closed->insert(frontier.g(), layer);
+      }
+    }
     // Process Simg, removing duplicates and computing h. Store in Sfilter and
     // reopen. Include new states in the open list
     for (auto &resImage : res_expansion.buckets) {
@@ -177,6 +250,18 @@ bool UniformCostSearch::stepImage(int maxTime, int maxNodes) {
   } else {
     estimationZero.stepTaken(1000 * res_expansion.time_spent, stepNodes);
   }
+  if (res_expansion.ok && estimated_time > 0) {
+    // Same 10ms offset as the estimations
+    double ratio = (1000 * res_expansion.time_spent + 10) / estimated_time;
+    time_correction = TIME_CORRECTION_WEIGHT * ratio +
+                      (1 - TIME_CORRECTION_WEIGHT) * time_correction;
+  }
+
+  if (trace) {
+    mgr->set_image_stats(nullptr);
+    trace_step("step", g, frontier_nodes, prepare_res, &res_expansion,
+               estimation, stepNodes, image_stats, sTime());
+  }
 
   // Try to prepare next Bucket
   computeEstimation(true);
@@ -199,10 +284,91 @@ bool UniformCostSearch::stepImage(int maxTime, int maxNodes) {
   return res_expansion.ok;
 }
 
+void UniformCostSearch::trace_step(const string &event, int g,
+                                   long frontier_nodes,
+                                   const Result &prepare_res,
+                                   const ResultExpansion *res_expansion,
+                                   const Estimation &estimation,
+                                   long result_nodes,
+                                   const vector<ImageStats> &image_stats,
+                                   double time) const {
+  SymTraceRecord record;
+  record.add("event", event)
+      .add("dir", fw ? "fw" : "bw")
+      .add("g", g)
+      .add("frontier_nodes", frontier_nodes)
+      .add("filter_time", prepare_res.filter_time)
+      .add("merge_time", prepare_res.merge_time);
+
+  const Result &res = res_expansion ? *res_expansion : prepare_res;
+  record.add("ok", res.ok);
+  if (!res.ok) {
+    ostringstream reason;
+    reason << res.truncated_reason;
+    record.add("truncated", reason.str());
+  }
+
+  if (res_expansion) {
+    vector<SymTraceRecord> images(image_stats.size());
+    for (size_t i = 0; i < image_stats.size(); ++i) {
+      images[i]
+          .add("cost", image_stats[i].cost)
+          .add("tr", image_stats[i].tr)
+          .add("time", image_stats[i].time)
+          .add("nodes", image_stats[i].nodes);
+    }
+    record.add("zero", res_expansion->step_zero)
+        .add("image_time", res_expansion->time_spent)
+        .add("estimated_time", estimation.time / 1000.0)
+        .add("estimated_nodes", (long)estimation.nodes)
+        .add("images", images);
+  }
+  record.add("result_nodes", result_nodes)
+      .add("time", time)
+      .add("total_time", (double)utils::g_timer())
+      .add("cudd", SymTrace::cudd_stats(*mgr->getVars()->get_manager()));
+  engine->get_trace()->write(record);
+}
+
 bool UniformCostSearch::isSearchableWithNodes(int maxNodes) const {
   return frontier.expansionReady() && nextStepNodes() <= maxNodes;
 }
 
+void UniformCostSearch::getBDDs(Bucket &closed_bdds, Bucket &open_bdds) const {
+  closed->getBDDs(closed_bdds);
+  open_list.getBuckets(open_bdds);
+  frontier.getBuckets(open_bdds);
+}
+
+void UniformCostSearch::print_layer_memory() const {
+  cout << "Closed layers " << (fw ? "fw" : "bw") << ":" << endl;
+  closed->print_layer_memory();
+}
+
+void UniformCostSearch::write_profile(ostream &file) const {
+  file << "direction " << (fw ? "fw" : "bw") << endl;
+  file << "max_step_nodes " << p.maxStepNodes << endl;
+  estimationCost.write(file);
+  estimationZero.write(file);
+}
+
+bool UniformCostSearch::read_profile(const string &profile) {
+  const string header = string("direction ") + (fw ? "fw" : "bw");
+  istringstream file(profile);
+  string line;
+  while (getline(file, line) && line != header) {
+  }
+  if (!file || !getline(file, line)) {
+    return false;
+  }
+  // The step size limit is only lowered, never beyond the configured one
+  p.maxStepNodes = min(p.maxStepNodes, getData<int>(line, " ", ""));
+  estimationCost.read(file);
+  estimationZero.read(file);
+  computeEstimation(false);
+  return true;
+}
+
 void UniformCostSearch::computeEstimation(bool prepare) {
   if (prepare) {
     prepareBucket(/*p.max_pop_time, p.max_pop_nodes, true*/);
@@ -257,6 +423,15 @@ long UniformCostSearch::nextStepNodesResult() const {
   return estimation;
 }
 
+double UniformCostSearch::predictedStepTime(bool lookahead) const {
+  double estimation = nextStepTime();
+  if (lookahead) {
+    // The image is mostly expanded with cost transitions
+    estimation += estimationCost.estimate(nextStepNodesResult()).time;
+  }
+  return estimation * time_correction;
+}
+
 void UniformCostSearch::violated(TruncatedReason /*reason*/,
                                  double ellapsed_seconds, int maxTime,
                                  int maxNodes) {
@@ -59,6 +59,10 @@ protected:
   bool lastStepCost; // If the last step was a cost step (to know if we are in
                      // estimationDisjCost or Zero)
 
+  // Running average of the observed time of a step divided by its estimated
+  // time, i.e., how much the estimations of this direction are off
+  double time_correction;
+
   int last_g_cost;
 
   void violated(TruncatedReason reason, double time, int maxTime, int maxNodes);
@@ -81,8 +85,25 @@ protected:
 
   virtual void filterFrontier();
 
+  // States removed from the frontier because they have been closed before
+  virtual BDD frontierClosed() const;
+
   void computeEstimation(bool prepare);
 
+  // Common part of init once the frontier or open list and the closed list
+  // are set
+  bool init_search(std::shared_ptr<SymStateSpaceManager> manager, bool fw,
+                   UniformCostSearch *opposite_search);
+
+  // Writes a record of a step (or of a prepared bucket if res_expansion is
+  // null) to the trace of the engine
+  void trace_step(const std::string &event, int g, long frontier_nodes,
+                  const Result &prepare_res,
+                  const ResultExpansion *res_expansion,
+                  const Estimation &estimation, long result_nodes,
+                  const std::vector<ImageStats> &image_stats,
+                  double time) const;
+
   //////////////////////////////////////////////////////////////////////////////
 public:
   UniformCostSearch(SymbolicSearch *eng, const SymParamsSearch &params);
@@ -102,6 +123,14 @@ public:
   init(std::shared_ptr<SymStateSpaceManager> manager, bool fw,
        UniformCostSearch *opposite_search); // Init forward or backward search
 
+  // Continues a search whose closed states are given per cost, in the order
+  // they were closed (zero-cost sublayers), and whose open states are given
+  // per cost
+  bool init(std::shared_ptr<SymStateSpaceManager> manager, bool fw,
+            UniformCostSearch *opposite_search,
+            const std::map<int, Bucket> &closed_layers,
+            const std::map<int, BDD> &open_states);
+
   virtual bool isSearchableWithNodes(int maxNodes) const;
 
   virtual int getF() const override {
@@ -120,12 +149,23 @@ public:
   virtual long nextStepNodes() const override;
   virtual long nextStepNodesResult() const override;
 
+  // Estimated time of the next step, corrected by the observed step times.
+  // With lookahead, the time of a step on the estimated image is added.
+  double predictedStepTime(bool lookahead) const;
+
   // Returns the nodes that have been expanded by the algorithm (closed without
   // the current frontier)
   BDD getExpanded() const;
   void getNotExpanded(Bucket &res) const;
 
-  // void write(const std::string & file) const;
+  virtual void getBDDs(Bucket &closed_bdds, Bucket &open_bdds) const override;
+
+  virtual void print_layer_memory() const override;
+
+  // Writes the step size limit and the estimations of this direction
+  virtual void write_profile(std::ostream &file) const override;
+  // Loads the section of this direction and re-estimates the next step
+  virtual bool read_profile(const std::string &profile) override;
 
   void filterMutex(Bucket &bucket) {
     mgr->filterMutex(bucket, fw, initialization());
@@ -3,13 +3,15 @@
 #include "../option_parser.h"
 #include "../sym_variables.h"
 
+#include "../../utils/timer.h"
+
 #include <limits>
 #include <queue>
 
 namespace symbolic {
 using namespace std;
 
-SymAxiomCompilation::SymAxiomCompilation(std::shared_ptr<SymVariables> sym_vars)
+SymAxiomCompilation::SymAxiomCompilation(SymVariables *sym_vars)
     : sym_vars(sym_vars), task(*tasks::g_root_task) {}
 
 bool SymAxiomCompilation::is_derived_variable(int var) const {
@@ -100,8 +102,16 @@ BDD SymAxiomCompilation::get_primary_representation(int var, int val) const {
                                                                     : res;
 }
 
+void SymAxiomCompilation::copy_primary_representations(
+    const SymAxiomCompilation &other, Cudd &manager) {
+  primary_representations.clear();
+  for (const auto &entry : other.primary_representations) {
+    primary_representations[entry.first] = entry.second.Transfer(manager);
+  }
+}
+
 void SymAxiomCompilation::create_primary_representations() {
-  create_axiom_body_layer();
+  create_body_var_index();
   for (size_t i = 0; i < task.get_variables().size(); i++) {
     if (is_derived_variable(i)) {
       primary_representations[i] = sym_vars->zeroBDD();
@@ -114,29 +124,43 @@ void SymAxiomCompilation::create_primary_representations() {
   }
 }
 
+// Semi-naive fixpoint: when the representation of a variable grows by
+// delta, only the axioms with the variable in the body are reevaluated, and
+// only on delta instead of the whole representation
 void SymAxiomCompilation::create_primary_representations(int layer) {
-  std::cout << "LAYER " << layer << "..." << std::flush;
-  std::vector<int> rules_in_layer;
-  // add all "unproblematic" axioms to var bdd
+  utils::Timer timer;
+  int num_rules = 0;
+  int num_updates = 0;
+
+  // Lower layers are final, so their part of the bodies is computed once
+  map<int, BDD> lower_body;
   for (size_t i = 0; i < task.get_axioms().size(); i++) {
-    if (is_trivial_axiom(i)) {
-      continue;
+    if (!is_trivial_axiom(i) && get_axiom_level(i) == layer) {
+      lower_body[i] = get_lower_layer_body_bdd(i);
+      ++num_rules;
     }
-    auto axiom = task.get_axioms()[i];
-    int head = axiom.get_effects()[0].get_fact().get_variable().get_id();
+  }
 
-    if (get_axiom_level(i) == layer && axiom_body_layer.at(i) < layer) {
-      BDD body = get_body_bdd(i);
-      primary_representations[head] += body;
+  // add all "unproblematic" axioms to var bdd
+  for (const auto &entry : lower_body) {
+    if (same_layer_body_vars[entry.first].empty()) {
+      int head = task.get_axioms()[entry.first]
+                     .get_effects()[0]
+                     .get_fact()
+                     .get_variable()
+                     .get_id();
+      primary_representations[head] += entry.second;
     }
   }
+
   // add vars of this layer to queue
+  map<int, BDD> delta;
   std::queue<int> open_vars;
   for (auto &cur : primary_representations) {
     int head = cur.first;
     int head_level = task.get_variables()[head].get_axiom_layer();
     if (head_level == layer) {
-      // std::cout << g_variable_name[var] << std::endl;
+      delta[head] = cur.second;
       open_vars.push(head);
     }
   }
@@ -145,51 +169,75 @@ void SymAxiomCompilation::create_primary_representations(int layer) {
   while (!open_vars.empty()) {
     int var = open_vars.front();
     open_vars.pop();
-    for (size_t i = 0; i < task.get_axioms().size(); i++) {
-      auto axiom = task.get_axioms()[i];
-      int head = axiom.get_effects()[0].get_fact().get_variable().get_id();
-      int head_level = task.get_variables()[head].get_axiom_layer();
-      if (is_trivial_axiom(i) || head_level != layer) {
-        continue;
+    BDD var_delta = delta[var];
+    delta[var] = sym_vars->zeroBDD();
+    if (var_delta.IsZero()) {
+      continue;
+    }
+    for (int i : axioms_with_body_var[var]) {
+      int head = task.get_axioms()[i]
+                     .get_effects()[0]
+                     .get_fact()
+                     .get_variable()
+                     .get_id();
+      BDD body = lower_body.at(i) * var_delta;
+      for (int body_var : same_layer_body_vars[i]) {
+        if (body_var != var) {
+          body *= primary_representations[body_var];
+        }
       }
-      if (is_in_body(var, i)) {
-
-        BDD res = primary_representations[head];
-        BDD body = get_body_bdd(i);
-        res += (body * primary_representations[var]);
-        if (res != primary_representations[head]) {
+      BDD new_states = body * !primary_representations[head];
+      if (!new_states.IsZero()) {
+        primary_representations[head] += new_states;
+        if (delta[head].IsZero()) {
           open_vars.push(head);
         }
-        primary_representations[head] = res;
-        // std::cout << g_variable_name[head] << " updated" << std::endl;
+        delta[head] += new_states;
+        ++num_updates;
       }
     }
   }
-  std::cout << "done!" << std::endl;
+  std::cout << "Axiom layer " << layer << ": " << num_rules << " rules, "
+            << num_updates << " updates, " << timer << std::endl;
 }
 
-void SymAxiomCompilation::create_axiom_body_layer() {
+// Derived conditions of the same layer are positive in stratified axioms
+bool SymAxiomCompilation::is_same_layer_condition(const FactProxy &cond,
+                                                  int layer) const {
+  VariableProxy var = cond.get_variable();
+  return var.is_derived() && var.get_axiom_layer() == layer &&
+         cond.get_value() != var.get_default_axiom_value();
+}
+
+void SymAxiomCompilation::create_body_var_index() {
+  axioms_with_body_var.assign(task.get_variables().size(), vector<int>());
+  same_layer_body_vars.assign(task.get_axioms().size(), vector<int>());
   for (size_t i = 0; i < task.get_axioms().size(); i++) {
-    int body_level = -1;
+    if (is_trivial_axiom(i)) {
+      continue;
+    }
+    int layer = get_axiom_level(i);
     const EffectProxy eff = task.get_axioms()[i].get_effects()[0];
     for (size_t cond_i = 0; cond_i < eff.get_conditions().size(); cond_i++) {
-      int level = eff.get_conditions()[cond_i].get_variable().get_axiom_layer();
-      body_level = std::max(body_level, level);
+      FactProxy cond = eff.get_conditions()[cond_i];
+      if (is_same_layer_condition(cond, layer)) {
+        VariableProxy var = cond.get_variable();
+        axioms_with_body_var[var.get_id()].push_back(i);
+        same_layer_body_vars[i].push_back(var.get_id());
+      }
     }
-    axiom_body_layer.push_back(body_level);
   }
 }
 
-BDD SymAxiomCompilation::get_body_bdd(int axiom_id) const {
+BDD SymAxiomCompilation::get_lower_layer_body_bdd(int axiom_id) const {
   BDD res = sym_vars->oneBDD();
+  int layer = get_axiom_level(axiom_id);
   EffectProxy eff = task.get_axioms()[axiom_id].get_effects()[0];
   for (size_t cond_i = 0; cond_i < eff.get_conditions().size(); cond_i++) {
-    int var = eff.get_conditions()[cond_i].get_variable().get_id();
-    int val = eff.get_conditions()[cond_i].get_value();
-    if (!is_derived_variable(var)) {
-      res *= sym_vars->preBDD(var, val);
-    } else {
-      res *= get_primary_representation(var, val);
+    FactProxy cond = eff.get_conditions()[cond_i];
+    if (!is_same_layer_condition(cond, layer)) {
+      res *= get_primary_representation(cond.get_variable().get_id(),
+                                        cond.get_value());
     }
   }
   return res;
@@ -13,7 +13,7 @@ class SymVariables;
 class SymAxiomCompilation {
 
 public:
-  SymAxiomCompilation(std::shared_ptr<SymVariables> sym_vars);
+  SymAxiomCompilation(SymVariables *sym_vars);
 
   bool is_derived_variable(int var) const;
   bool is_in_body(int var, int axiom_id) const;
@@ -27,16 +27,28 @@ public:
   BDD get_compilied_goal_state() const;
   BDD get_primary_representation(int var, int val) const;
 
+  // Transfers the primary representations of other into manager
+  void copy_primary_representations(const SymAxiomCompilation &other,
+                                    Cudd &manager);
+
 protected:
-  std::shared_ptr<SymVariables> sym_vars; // For axiom creation
+  SymVariables *sym_vars; // For axiom creation (not owned)
   TaskProxy task;
-  std::vector<int> axiom_body_layer;
   std::map<int, BDD> primary_representations;
 
+  // Derived variable => non-trivial axioms with the variable in the body and
+  // the head in the same layer (the axioms to reevaluate if it grows)
+  std::vector<std::vector<int>> axioms_with_body_var;
+  // Body variables of each axiom in the layer of its head
+  std::vector<std::vector<int>> same_layer_body_vars;
+
   void create_primary_representations();
   void create_primary_representations(int layer);
-  void create_axiom_body_layer();
-  BDD get_body_bdd(int axiom_id) const;
+  void create_body_var_index();
+  bool is_same_layer_condition(const FactProxy &cond, int layer) const;
+  // Conjunction of the body conditions on variables of lower layers, which
+  // are final when the axiom's layer is computed
+  BDD get_lower_layer_body_bdd(int axiom_id) const;
 };
 
 } // namespace symbolic
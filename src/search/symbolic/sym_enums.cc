@@ -25,12 +25,12 @@ std::ostream &operator<<(std::ostream &os, const MutexType &m) {
     return os << "edeletion";
   case MutexType::MUTEX_AND:
     return os << "and";
-    /*case MutexType::MUTEX_RESTRICT:
-        return os << "restrict";
-    case MutexType::MUTEX_NPAND:
+  case MutexType::MUTEX_RESTRICT:
+    return os << "restrict";
+  case MutexType::MUTEX_CONSTRAIN:
+    return os << "constrain";
+    /*case MutexType::MUTEX_NPAND:
         return os << "npand";
-    case MutexType::MUTEX_CONSTRAIN:
-        return os << "constrain";
     case MutexType::MUTEX_LICOMP:
         return os << "licompaction";*/
   default:
@@ -39,9 +39,79 @@ std::ostream &operator<<(std::ostream &os, const MutexType &m) {
   }
 }
 
+std::ostream &operator<<(std::ostream &os, const ZeroCostExpansion &z) {
+  switch (z) {
+  case ZeroCostExpansion::BFS:
+    return os << "bfs";
+  case ZeroCostExpansion::CHAINING:
+    return os << "chaining";
+  case ZeroCostExpansion::SATURATION:
+    return os << "saturation";
+  default:
+    std::cerr << "Name of ZeroCostExpansion not known";
+    utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+  }
+}
+
+std::ostream &operator<<(std::ostream &os, const MemoryTimeline &m) {
+  switch (m) {
+  case MemoryTimeline::NONE:
+    return os << "none";
+  case MemoryTimeline::SUMMARY:
+    return os << "summary";
+  case MemoryTimeline::STREAM:
+    return os << "stream";
+  default:
+    std::cerr << "Name of MemoryTimeline not known";
+    utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+  }
+}
+
+std::ostream &operator<<(std::ostream &os, const DirectionSelection &d) {
+  switch (d) {
+  case DirectionSelection::NODES:
+    return os << "nodes";
+  case DirectionSelection::TIME:
+    return os << "time";
+  case DirectionSelection::TIME_LOOKAHEAD:
+    return os << "time_lookahead";
+  default:
+    std::cerr << "Name of DirectionSelection not known";
+    utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+  }
+}
+
+std::ostream &operator<<(std::ostream &os, const TruncatedReason &reason) {
+  switch (reason) {
+  case TruncatedReason::FILTER_MUTEX:
+    return os << "filter_mutex";
+  case TruncatedReason::MERGE_BUCKET:
+    return os << "merge_bucket";
+  case TruncatedReason::MERGE_BUCKET_COST:
+    return os << "merge_bucket_cost";
+  case TruncatedReason::IMAGE_ZERO:
+    return os << "image_zero";
+  case TruncatedReason::IMAGE_COST:
+    return os << "image_cost";
+  default:
+    std::cerr << "Name of TruncatedReason not known";
+    utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+  }
+}
+
 const std::vector<std::string> MutexTypeValues{
-    "MUTEX_NOT", "MUTEX_AND", "MUTEX_EDELETION",
-    /*"MUTEX_RESTRICT", "MUTEX_NPAND", "MUTEX_CONSTRAIN", "MUTEX_LICOMP"*/};
+    "MUTEX_NOT",      "MUTEX_AND",       "MUTEX_EDELETION",
+    "MUTEX_RESTRICT", "MUTEX_CONSTRAIN",
+    /*"MUTEX_NPAND", "MUTEX_LICOMP"*/};
+
+const std::vector<std::string> ZeroCostExpansionValues{"BFS", "CHAINING",
+                                                       "SATURATION"};
+
+const std::vector<std::string> MemoryTimelineValues{"NONE", "SUMMARY",
+                                                    "STREAM"};
+
+const std::vector<std::string> DirectionSelectionValues{"NODES", "TIME",
+                                                       "TIME_LOOKAHEAD"};
 
 const std::vector<std::string> DirValues{"FW", "BW", "BIDIR"};
 } // namespace symbolic
@@ -16,11 +16,37 @@ enum class MutexType {
   MUTEX_NOT,
   MUTEX_AND,
   MUTEX_EDELETION,
-  /*MUTEX_RESTRICT, MUTEX_NPAND, MUTEX_CONSTRAIN, MUTEX_LICOMP*/
+  // As MUTEX_AND, but each mutex BDD is simplified with respect to the
+  // filtered BDD before the conjunction, and the mutex BDDs are applied in
+  // order of their measured pruning power
+  MUTEX_RESTRICT,
+  MUTEX_CONSTRAIN,
+  /*MUTEX_NPAND, MUTEX_LICOMP*/
 };
 std::ostream &operator<<(std::ostream &os, const MutexType &m);
 extern const std::vector<std::string> MutexTypeValues;
 
+// How zero-cost transitions are expanded: one image per step (BFS) or
+// up to a fixpoint in a single step, applying the TRs one after another
+// (CHAINING) or ordered by the level of their top variable (SATURATION)
+enum class ZeroCostExpansion { BFS, CHAINING, SATURATION };
+std::ostream &operator<<(std::ostream &os, const ZeroCostExpansion &z);
+extern const std::vector<std::string> ZeroCostExpansionValues;
+
+// Events of the CUDD manager (garbage collections and reorderings): not
+// recorded (NONE), summarized at the end (SUMMARY) or also printed as they
+// occur (STREAM)
+enum class MemoryTimeline { NONE, SUMMARY, STREAM };
+std::ostream &operator<<(std::ostream &os, const MemoryTimeline &m);
+extern const std::vector<std::string> MemoryTimelineValues;
+
+// How bidirectional search picks the direction of the next step: smaller
+// frontier (NODES), smaller predicted step time (TIME) or smaller predicted
+// time of the step plus the step on its estimated image (TIME_LOOKAHEAD)
+enum class DirectionSelection { NODES, TIME, TIME_LOOKAHEAD };
+std::ostream &operator<<(std::ostream &os, const DirectionSelection &d);
+extern const std::vector<std::string> DirectionSelectionValues;
+
 enum class Dir { FW, BW, BIDIR };
 std::ostream &operator<<(std::ostream &os, const Dir &dir);
 extern const std::vector<std::string> DirValues;
@@ -33,7 +59,7 @@ enum class TruncatedReason {
   IMAGE_ZERO,
   IMAGE_COST
 };
-// std::ostream &operator<<(std::ostream &os, const TruncatedReason &dir);
+std::ostream &operator<<(std::ostream &os, const TruncatedReason &reason);
 
 } // namespace symbolic
 #endif
\ No newline at end of file
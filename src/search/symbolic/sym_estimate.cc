@@ -59,20 +59,15 @@ void SymStepCostEstimation::stepTaken(double time, double nodes) {
                  nodes)); // consider 10ms more to avoid values close to 0
 }
 
-// Sets the nodes of next iteration and recalculate estimations
-void SymStepCostEstimation::nextStep(double nodes) {
-#ifdef DEBUG_ESTIMATES
-  cout << "== NEXT STEP: " << nodes << " " << *this << " to ";
-#endif
-  nextStepNodes = nodes;
-
-  if (data.count(nodes)) {
-    return; // We already have an estimation in our data :D
+Estimation SymStepCostEstimation::estimate(long nodes) const {
+  auto it = data.find(nodes);
+  if (it != std::end(data)) {
+    return it->second; // We already have an estimation in our data :D
   }
 
   double estimatedTime, estimatedNodes;
   // Get next data point
-  auto nextIt = data.upper_bound(nextStepNodes);
+  auto nextIt = data.upper_bound(nodes);
   if (nextIt == std::end(data)) {
     // This is greater than any est we have, just get the greatest
     --nextIt;
@@ -83,11 +78,10 @@ void SymStepCostEstimation::nextStep(double nodes) {
       estimatedTime = prevEst.time;
       estimatedNodes = prevEst.nodes;
     } else {
-      double incrementNodes = max(0.0, nextStepNodes - prevEst.nodes);
-      estimatedNodes = nextStepNodes + incrementNodes;
+      double incrementNodes = max(0.0, nodes - prevEst.nodes);
+      estimatedNodes = nodes + incrementNodes;
 
-      double proportionNodes =
-          ((double)estimatedNodes) / ((double)nextStepNodes);
+      double proportionNodes = ((double)estimatedNodes) / ((double)nodes);
       estimatedTime = prevEst.time * proportionNodes;
     }
   } else {
@@ -99,14 +93,22 @@ void SymStepCostEstimation::nextStep(double nodes) {
     Estimation prevEst = nextIt->second;
 
     // Interpolate
-    double percentage = ((double)(nextStepNodes - prevNodes)) /
-                        ((double)(nextNodes - prevNodes));
+    double percentage =
+        ((double)(nodes - prevNodes)) / ((double)(nextNodes - prevNodes));
     estimatedTime = prevEst.time + percentage * (nextEst.time - prevEst.time);
     estimatedNodes =
         prevEst.nodes + percentage * (nextEst.nodes - prevEst.nodes);
   }
+  return Estimation(estimatedTime, estimatedNodes);
+}
 
-  estimation = Estimation(estimatedTime, estimatedNodes);
+// Sets the nodes of next iteration and recalculate estimations
+void SymStepCostEstimation::nextStep(double nodes) {
+#ifdef DEBUG_ESTIMATES
+  cout << "== NEXT STEP: " << nodes << " " << *this << " to ";
+#endif
+  nextStepNodes = nodes;
+  estimation = estimate(nextStepNodes);
 #ifdef DEBUG_ESTIMATES
   cout << *this << endl;
   if (this->nodes() <= 0) {
@@ -152,7 +154,7 @@ ostream &operator<<(ostream &os, const SymStepCostEstimation &est) {
             << est.nodes() << " nodes)";
 }
 
-void SymStepCostEstimation::write(ofstream &file) const {
+void SymStepCostEstimation::write(ostream &file) const {
   file << nextStepNodes << " => " << estimation << endl;
   for (const auto &d : data) {
     file << d.first << " => " << d.second << endl;
@@ -160,15 +162,13 @@ void SymStepCostEstimation::write(ofstream &file) const {
   file << endl;
 }
 
-void SymStepCostEstimation::read(ifstream &file) {
+void SymStepCostEstimation::read(istream &file) {
   string line;
   getline(file, line);
-  cout << "ESTIMATE PARSE: " << line << endl;
   nextStepNodes = getData<long>(line, "", "=");
   estimation = Estimation(getData<double>(line, ">", ","),
                           getData<double>(line, ",", ""));
   while (getline(file, line) && !line.empty()) {
-    cout << "ESTIMATE PARSE: " << line << endl;
     data[getData<long>(line, "", "=")] = Estimation(
         getData<double>(line, ">", ","), getData<double>(line, ",", ""));
   }
@@ -60,6 +60,9 @@ public:
   void nextStep(double nodes); // Called before any step, telling number of
                                // nodes to expand
 
+  // Estimation of a step on a BDD of the given size (e.g., to look ahead)
+  Estimation estimate(long nodes) const;
+
   // Recompute the estimation if it has been exceeded
   void violated(double time_ellapsed, double time_limit, double node_limit);
 
@@ -75,8 +78,8 @@ public:
 
   friend std::ostream &operator<<(std::ostream &os,
                                   const SymStepCostEstimation &est);
-  void write(std::ofstream &file) const;
-  void read(std::ifstream &file);
+  void write(std::ostream &file) const;
+  void read(std::istream &file);
 };
 } // namespace symbolic
 #endif
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "sym_memory_timeline.h"
+
+#include "../utils/timer.h"
+
+#include <algorithm>
+#include <iomanip>
+
+using namespace std;
+
+namespace symbolic {
+
+static double to_mb(size_t bytes) { return bytes / (1024.0 * 1024.0); }
+
+ostream &operator<<(ostream &os, const MemoryEvent &event) {
+  return os << "Memory event: " << event.type << " at " << event.start
+            << "s, duration: " << event.duration
+            << "s, freed nodes: " << event.freed_nodes
+            << ", memory: " << to_mb(event.memory_before) << " MB -> "
+            << to_mb(event.memory) << " MB, cache slots: " << event.cache_slots;
+}
+
+SymMemoryTimeline::SymMemoryTimeline(Cudd &manager, bool stream)
+    : manager(manager), stream(stream), keys_before(0), peak_memory(0) {
+  DdManager *dd = manager.getManager();
+  Cudd_SetApplicationHook(dd, this);
+  Cudd_AddHook(dd, pre_gc_hook, CUDD_PRE_GC_HOOK);
+  Cudd_AddHook(dd, post_gc_hook, CUDD_POST_GC_HOOK);
+  Cudd_AddHook(dd, pre_reordering_hook, CUDD_PRE_REORDERING_HOOK);
+  Cudd_AddHook(dd, post_reordering_hook, CUDD_POST_REORDERING_HOOK);
+}
+
+SymMemoryTimeline::~SymMemoryTimeline() {
+  DdManager *dd = manager.getManager();
+  Cudd_RemoveHook(dd, pre_gc_hook, CUDD_PRE_GC_HOOK);
+  Cudd_RemoveHook(dd, post_gc_hook, CUDD_POST_GC_HOOK);
+  Cudd_RemoveHook(dd, pre_reordering_hook, CUDD_PRE_REORDERING_HOOK);
+  Cudd_RemoveHook(dd, post_reordering_hook, CUDD_POST_REORDERING_HOOK);
+  Cudd_SetApplicationHook(dd, nullptr);
+}
+
+SymMemoryTimeline *SymMemoryTimeline::get_timeline(DdManager *dd) {
+  return static_cast<SymMemoryTimeline *>(Cudd_ReadApplicationHook(dd));
+}
+
+// Hooks must return 1, otherwise CUDD aborts the operation
+int SymMemoryTimeline::pre_gc_hook(DdManager *dd, const char *, void *) {
+  get_timeline(dd)->start_event("gc");
+  return 1;
+}
+
+int SymMemoryTimeline::post_gc_hook(DdManager *dd, const char *, void *) {
+  get_timeline(dd)->finish_event();
+  return 1;
+}
+
+int SymMemoryTimeline::pre_reordering_hook(DdManager *dd, const char *,
+                                           void *) {
+  get_timeline(dd)->start_event("reordering");
+  return 1;
+}
+
+int SymMemoryTimeline::post_reordering_hook(DdManager *dd, const char *,
+                                            void *) {
+  get_timeline(dd)->finish_event();
+  return 1;
+}
+
+void SymMemoryTimeline::start_event(const string &type) {
+  current.type = type;
+  current.start = utils::g_timer();
+  current.memory_before = manager.ReadMemoryInUse();
+  keys_before = manager.ReadKeys();
+  peak_memory = max(peak_memory, current.memory_before);
+}
+
+void SymMemoryTimeline::finish_event() {
+  current.duration = utils::g_timer() - current.start;
+  current.freed_nodes = (long)keys_before - (long)manager.ReadKeys();
+  current.memory = manager.ReadMemoryInUse();
+  current.cache_slots = manager.ReadCacheSlots();
+  events.push_back(current);
+  if (stream) {
+    cout << current << endl;
+  }
+}
+
+size_t SymMemoryTimeline::get_peak_memory() const {
+  return max(peak_memory, (size_t)manager.ReadMemoryInUse());
+}
+
+void SymMemoryTimeline::print_timeline() const {
+  for (const MemoryEvent &event : events) {
+    cout << event << endl;
+  }
+}
+
+void SymMemoryTimeline::print_summary(
+    const vector<pair<string, vector<BDD>>> &bdds) const {
+  for (const string type : {"gc", "reordering"}) {
+    int num_events = 0;
+    double total_time = 0, max_time = 0;
+    for (const MemoryEvent &event : events) {
+      if (event.type == type) {
+        ++num_events;
+        total_time += event.duration;
+        max_time = max(max_time, event.duration);
+      }
+    }
+    cout << "Memory events " << type << ": " << num_events
+         << ", total time: " << total_time << "s, max time: " << max_time
+         << "s" << endl;
+  }
+
+  cout << fixed << setprecision(2);
+  cout << "Peak memory in use: " << to_mb(get_peak_memory()) << " MB" << endl;
+  cout << "Memory in use: " << to_mb(manager.ReadMemoryInUse())
+       << " MB, max memory: " << to_mb(manager.ReadMaxMemory()) << " MB"
+       << endl;
+  cout << defaultfloat;
+  cout << "Unique table: " << manager.ReadKeys() << " nodes ("
+       << manager.ReadDead() << " dead, peak: " << manager.ReadPeakNodeCount()
+       << ") in " << manager.ReadSlots() << " slots" << endl;
+  cout << "Cache: " << manager.ReadCacheSlots() << " slots, "
+       << manager.ReadCacheUsedSlots() * 100 << "% used" << endl;
+  // Nodes shared by several groups are counted in each of them
+  for (const auto &group : bdds) {
+    int nodes = group.second.empty() ? 0 : manager.SharingSize(group.second);
+    cout << "BDD nodes " << group.first << ": " << nodes << endl;
+  }
+}
+} // namespace symbolic
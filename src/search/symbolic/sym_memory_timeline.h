@@ -0,0 +1,70 @@
+#ifndef SYMBOLIC_SYM_MEMORY_TIMELINE_H
+#define SYMBOLIC_SYM_MEMORY_TIMELINE_H
+
+#include "cuddObj.hh"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace symbolic {
+
+// A garbage collection or variable reordering of the CUDD manager
+struct MemoryEvent {
+  std::string type;
+  double start;         // Time of the planner (s)
+  double duration;      // s
+  long freed_nodes;     // Difference of nodes in the unique table
+  size_t memory;        // Memory in use after the event (bytes)
+  size_t memory_before; // Memory in use before the event (bytes)
+  unsigned int cache_slots;
+
+  friend std::ostream &operator<<(std::ostream &os, const MemoryEvent &event);
+};
+
+/*
+ * Records the garbage collections and reorderings of a CUDD manager by
+ * means of the pre/post hooks of CUDD. The events can be printed as they
+ * occur (stream) and are summarized at the end of the search.
+ */
+class SymMemoryTimeline {
+  Cudd &manager;
+  bool stream;
+  std::vector<MemoryEvent> events;
+  MemoryEvent current; // Event in progress
+  unsigned int keys_before;
+  size_t peak_memory; // Maximum memory in use observed at an event
+
+  static SymMemoryTimeline *get_timeline(DdManager *dd);
+  static int pre_gc_hook(DdManager *dd, const char *str, void *data);
+  static int post_gc_hook(DdManager *dd, const char *str, void *data);
+  static int pre_reordering_hook(DdManager *dd, const char *str, void *data);
+  static int post_reordering_hook(DdManager *dd, const char *str, void *data);
+
+  void start_event(const std::string &type);
+  void finish_event();
+
+public:
+  SymMemoryTimeline(Cudd &manager, bool stream);
+  ~SymMemoryTimeline();
+
+  SymMemoryTimeline(const SymMemoryTimeline &) = delete;
+  SymMemoryTimeline &operator=(const SymMemoryTimeline &) = delete;
+
+  const std::vector<MemoryEvent> &get_events() const { return events; }
+
+  size_t get_peak_memory() const;
+
+  void print_timeline() const;
+
+  /*
+   * Prints the totals of the events, the memory used by the unique
+   * table and the cache, and the BDD nodes of the given groups of BDDs,
+   * e.g., closed list, open list and TRs.
+   */
+  void print_summary(
+      const std::vector<std::pair<std::string, std::vector<BDD>>> &bdds) const;
+};
+} // namespace symbolic
+
+#endif
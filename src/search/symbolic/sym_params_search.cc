@@ -35,7 +35,12 @@ SymParamsSearch::SymParamsSearch(const Options &opts)
       ratioAllotedTime(opts.get<double>("ratio_alloted_time")),
       ratioAllotedNodes(opts.get<double>("ratio_alloted_nodes")),
       ratioAfterRelax(opts.get<double>("ratio_after_relax")),
-      non_stop(opts.get<bool>("non_stop")), debug(opts.get<bool>("debug")) {}
+      direction_selection(
+          DirectionSelection(opts.get_enum("direction_selection"))),
+      non_stop(opts.get<bool>("non_stop")),
+      relay_interval(opts.get<int>("relay_interval")),
+      delta_closed_layers(opts.get<bool>("delta_closed_layers")),
+      debug(opts.get<bool>("debug")) {}
 
 void SymParamsSearch::print_options() const {
   cout << "Disj(nodes=" << max_disj_nodes << ")" << endl;
@@ -55,6 +60,13 @@ void SymParamsSearch::print_options() const {
   cout << "   Mult alloted time: " << ratioAllotedTime
        << " nodes: " << ratioAllotedNodes << endl;
   cout << "   Ratio after relax: " << ratioAfterRelax << endl;
+  cout << "Direction selection: " << direction_selection << endl;
+  if (relay_interval > 0) {
+    cout << "Relay interval: " << relay_interval << endl;
+  }
+  if (delta_closed_layers) {
+    cout << "Closed list with delta layers" << endl;
+  }
 }
 
 void SymParamsSearch::add_options_to_parser(OptionParser &parser,
@@ -126,11 +138,33 @@ void SymParamsSearch::add_options_to_parser(OptionParser &parser,
                             "multiplier to decide alloted nodes for a step",
                             "0.8");
 
+  parser.add_enum_option("direction_selection", DirectionSelectionValues,
+                         "direction of the next step in bidirectional search: "
+                         "smaller frontier, smaller predicted step time, or "
+                         "smaller predicted time of the step and of the step "
+                         "on its estimated image",
+                         "NODES");
+
   parser.add_option<bool>(
       "non_stop",
       "Removes initial state from closed to avoid backward search to stop.",
       "false");
 
+  parser.add_option<int>(
+      "relay_interval",
+      "keep only the closed layers needed to regenerate the others from "
+      "relays every relay_interval cost units, and regenerate them for plan "
+      "reconstruction. Only used by unidirectional searches for a single "
+      "plan without plan counting (0 keeps all layers)",
+      "0", options::Bounds("0", "infinity"));
+
+  parser.add_option<bool>(
+      "delta_closed_layers",
+      "store the zero-cost sublayers of each closed layer as disjoint deltas "
+      "and only build the layers when plan reconstruction or the solution "
+      "cuts query them",
+      "false");
+
   parser.add_option<bool>("debug", "print debug trace", "false");
 }
 
@@ -1,6 +1,8 @@
 #ifndef SYMBOLIC_SYM_PARAMS_SEARCH_H
 #define SYMBOLIC_SYM_PARAMS_SEARCH_H
 
+#include "sym_enums.h"
+
 #include <algorithm>
 
 namespace options {
@@ -41,8 +43,17 @@ public:
 
   double ratioAfterRelax;
 
+  DirectionSelection direction_selection; // Only for bidirectional search
+
   bool non_stop;
 
+  // Interval between the relay layers kept in the closed list of single-plan
+  // unidirectional searches (0 keeps all layers)
+  int relay_interval;
+
+  // Store the zero-cost sublayers of the closed list as disjoint deltas
+  bool delta_closed_layers;
+
   bool debug;
 
   SymParamsSearch(const options::Options &opts);
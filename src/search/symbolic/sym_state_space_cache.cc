@@ -0,0 +1,83 @@
+#include "sym_state_space_cache.h"
+
+#include "original_state_space.h"
+#include "sym_enums.h"
+#include "sym_state_space_manager.h"
+#include "sym_variables.h"
+
+#include "../options/options.h"
+#include "../tasks/root_task.h"
+
+#include <iostream>
+
+using namespace std;
+
+namespace symbolic {
+
+namespace {
+struct StateSpaceCache {
+  // Root task the entries were created for, which is kept alive as long as
+  // the variables refer to it
+  shared_ptr<AbstractTask> task;
+  shared_ptr<SymVariables> vars;
+  // Declared after the variables, so that the BDDs are destroyed before the
+  // manager
+  unique_ptr<SymParamsMgr> params;
+  shared_ptr<OriginalStateSpace> state_space;
+
+  bool is_valid() const { return task && task == tasks::g_root_task; }
+
+  void clear() {
+    state_space = nullptr;
+    params = nullptr;
+    vars = nullptr;
+    task = nullptr;
+  }
+};
+
+StateSpaceCache &get_cache() {
+  static StateSpaceCache cache;
+  return cache;
+}
+} // namespace
+
+shared_ptr<SymVariables> get_cached_variables(const options::Options &opts) {
+  // The manager is only created by init
+  shared_ptr<SymVariables> vars = make_shared<SymVariables>(opts);
+  if (!tasks::g_root_task_reused ||
+      MemoryTimeline(opts.get_enum("memory_timeline")) !=
+          MemoryTimeline::NONE) {
+    vars->init();
+    return vars;
+  }
+
+  StateSpaceCache &cache = get_cache();
+  if (cache.vars && cache.is_valid() && cache.vars->same_options(*vars)) {
+    cout << "Reusing the symbolic variables of a previous search" << endl;
+    return cache.vars;
+  }
+  cache.clear();
+  cache.task = tasks::g_root_task;
+  cache.vars = vars;
+  cache.vars->init();
+  return cache.vars;
+}
+
+shared_ptr<OriginalStateSpace>
+get_cached_original_state_space(SymVariables *vars,
+                                const SymParamsMgr &params) {
+  StateSpaceCache &cache = get_cache();
+  if (vars != cache.vars.get() || !cache.is_valid()) {
+    return make_shared<OriginalStateSpace>(vars, params);
+  }
+  if (cache.state_space && cache.params->same_state_space(params)) {
+    cout << "Reusing the TRs and mutex BDDs of a previous search" << endl;
+  } else {
+    cache.state_space = nullptr;
+    cache.state_space = make_shared<OriginalStateSpace>(vars, params);
+    cache.params = unique_ptr<SymParamsMgr>(new SymParamsMgr(params));
+  }
+  return make_shared<OriginalStateSpace>(*cache.state_space);
+}
+
+} // namespace symbolic
@@ -0,0 +1,37 @@
+#ifndef SYMBOLIC_SYM_STATE_SPACE_CACHE_H
+#define SYMBOLIC_SYM_STATE_SPACE_CACHE_H
+
+#include <memory>
+
+namespace options {
+class Options;
+}
+
+namespace symbolic {
+class OriginalStateSpace;
+class SymParamsMgr;
+class SymVariables;
+
+/*
+ * Process-wide cache of the BDD variables (with their CUDD manager) and of
+ * the TRs and mutex BDDs of the original state space, so that consecutive
+ * requests of the planner service (see planner.cc) on the same root task
+ * skip their construction. It is only used if tasks::g_root_task_reused is
+ * set, since a single search gains nothing from it. Each search gets its own
+ * copy of the state space, which shares the BDDs but not the statistics.
+ * Everything is dropped once the root task is replaced.
+ */
+
+// Initialized variables for the options of a symbolic search. Variables
+// with a memory timeline are never shared, since it records one search.
+std::shared_ptr<SymVariables>
+get_cached_variables(const options::Options &opts);
+
+// Original state space with the given parameters. It is only cached for
+// variables obtained with get_cached_variables.
+std::shared_ptr<OriginalStateSpace>
+get_cached_original_state_space(SymVariables *vars,
+                                const SymParamsMgr &params);
+} // namespace symbolic
+
+#endif
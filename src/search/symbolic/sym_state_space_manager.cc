@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <numeric>
 #include <queue>
 
 using namespace std;
@@ -21,7 +22,9 @@ namespace symbolic {
 SymStateSpaceManager::SymStateSpaceManager(SymVariables *v,
                                            const SymParamsMgr &params,
                                            const set<int> &relevant_vars_)
-    : vars(v), p(params), relevant_vars(relevant_vars_),
+    : image_stats(nullptr), filter_time(0), image_time(0),
+      num_mutex_conjunctions(0), num_mutex_skipped(0), num_filterings(0),
+      vars(v), p(params), relevant_vars(relevant_vars_),
       initialState(v->zeroBDD()), goal(v->zeroBDD()), min_transition_cost(0),
       hasTR0(false) {
 
@@ -48,30 +51,80 @@ void SymStateSpaceManager::dumpMutexBDDs(bool fw) const {
   }
 }
 
+BDD SymStateSpaceManager::traced_image(const TransitionRelation &tr, int id,
+                                       const BDD &bdd, bool fw,
+                                       int nodeLimit) const {
+  utils::Timer timer;
+  BDD result = fw ? tr.image(bdd, nodeLimit) : tr.preimage(bdd, nodeLimit);
+  double time = timer();
+  image_time += time;
+  if (image_stats) {
+    image_stats->push_back(ImageStats{tr.getCost(), id, time,
+                                      result.nodeCount()});
+  }
+  return result;
+}
+
 void SymStateSpaceManager::zero_preimage(const BDD &bdd, vector<BDD> &res,
                                          int nodeLimit) const {
-  for (const auto &tr : transitions.at(0)) {
-    res.push_back(tr.preimage(bdd, nodeLimit));
+  const vector<TransitionRelation> &trs = transitions.at(0);
+  for (size_t i = 0; i < trs.size(); i++) {
+    res.push_back(traced_image(trs[i], i, bdd, false, nodeLimit));
   }
 }
 
 void SymStateSpaceManager::zero_image(const BDD &bdd, vector<BDD> &res,
                                       int nodeLimit) const {
-  for (const auto &tr : transitions.at(0)) {
-    res.push_back(tr.image(bdd, nodeLimit));
+  const vector<TransitionRelation> &trs = transitions.at(0);
+  for (size_t i = 0; i < trs.size(); i++) {
+    res.push_back(traced_image(trs[i], i, bdd, true, nodeLimit));
   }
 }
 
+void SymStateSpaceManager::partition_by_cost(
+    const BDD &bdd, size_t bit, size_t cost_index,
+    map<int, vector<BDD>> &res) const {
+  if (bdd.IsZero()) {
+    return;
+  }
+  if (bit == cost_vars.size()) {
+    assert(cost_index < cost_values.size());
+    res[cost_values[cost_index]].push_back(bdd);
+    return;
+  }
+  // The cost variables precede all state variables, so the cofactors are
+  // sub-BDDs of bdd
+  partition_by_cost(bdd.Cofactor(!cost_vars[bit]), bit + 1, 2 * cost_index,
+                    res);
+  partition_by_cost(bdd.Cofactor(cost_vars[bit]), bit + 1,
+                    2 * cost_index + 1, res);
+}
+
+void SymStateSpaceManager::encoded_cost_image(const BDD &bdd, bool fw,
+                                              map<int, vector<BDD>> &res,
+                                              int nodeLimit) const {
+  BDD result = zeroBDD();
+  for (size_t i = 0; i < cost_trs.size(); i++) {
+    result =
+        result.Or(traced_image(cost_trs[i], i, bdd, fw, nodeLimit), nodeLimit);
+  }
+  partition_by_cost(result, 0, 0, res);
+}
+
 void SymStateSpaceManager::cost_preimage(const BDD &bdd,
                                          map<int, vector<BDD>> &res,
                                          int nodeLimit) const {
+  if (!cost_trs.empty()) {
+    encoded_cost_image(bdd, false, res, nodeLimit);
+    return;
+  }
 
-  for (auto trs : transitions) {
+  for (const auto &trs : transitions) {
     int cost = trs.first;
     if (cost == 0)
       continue;
     for (size_t i = 0; i < trs.second.size(); i++) {
-      BDD result = trs.second[i].preimage(bdd, nodeLimit);
+      BDD result = traced_image(trs.second[i], i, bdd, false, nodeLimit);
       res[cost].push_back(result);
     }
   }
@@ -80,19 +133,185 @@ void SymStateSpaceManager::cost_preimage(const BDD &bdd,
 void SymStateSpaceManager::cost_image(const BDD &bdd,
                                       map<int, vector<BDD>> &res,
                                       int nodeLimit) const {
-  for (auto trs : transitions) {
+  if (!cost_trs.empty()) {
+    encoded_cost_image(bdd, true, res, nodeLimit);
+    return;
+  }
+  for (const auto &trs : transitions) {
     int cost = trs.first;
     if (cost == 0)
       continue;
     for (size_t i = 0; i < trs.second.size(); i++) {
-      BDD result = trs.second[i].image(bdd, nodeLimit);
+      BDD result = traced_image(trs.second[i], i, bdd, true, nodeLimit);
       res[cost].push_back(result);
     }
   }
 }
 
+bool SymStateSpaceManager::zero_fixpoint(const vector<size_t> &trs_ids,
+                                         bool fw, vector<BDD> &layers,
+                                         vector<size_t> &expanded, BDD &reached,
+                                         int maxNodes, bool initialization) {
+  const vector<TransitionRelation> &trs = transitions.at(0);
+  bool new_states = false;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t id : trs_ids) {
+      if (expanded[id] == layers.size()) {
+        continue;
+      }
+      BDD from = zeroBDD();
+      for (size_t i = expanded[id]; i < layers.size(); ++i) {
+        from += layers[i];
+      }
+      expanded[id] = layers.size();
+
+      BDD succ = traced_image(trs[id], id, from, fw, maxNodes);
+      succ = filter_mutex(succ * !reached, fw, maxNodes, initialization);
+      if (!succ.IsZero()) {
+        reached += succ;
+        layers.push_back(succ);
+        new_states = changed = true;
+      }
+    }
+  }
+  return new_states;
+}
+
+void SymStateSpaceManager::zero_closure(bool fw, const BDD &bdd,
+                                        const BDD &reached,
+                                        vector<BDD> &layers, int maxNodes,
+                                        bool initialization) {
+  const vector<TransitionRelation> &trs = transitions.at(0);
+  vector<BDD> all_layers{bdd};
+  vector<size_t> expanded(trs.size(), 0);
+  BDD all_reached = reached + bdd;
+
+  // Groups of TRs applied together: all TRs for chaining and TRs with the
+  // same top variable, bottom-most first, for saturation
+  vector<vector<size_t>> groups;
+  if (p.zero_cost_expansion == ZeroCostExpansion::SATURATION) {
+    map<int, vector<size_t>, greater<int>> trs_by_level;
+    for (size_t id = 0; id < trs.size(); ++id) {
+      int index = trs[id].getBDD().NodeReadIndex();
+      trs_by_level[vars->get_manager()->ReadPerm(index)].push_back(id);
+    }
+    for (auto &level_trs : trs_by_level) {
+      groups.push_back(level_trs.second);
+    }
+  } else {
+    groups.emplace_back(trs.size());
+    iota(groups[0].begin(), groups[0].end(), 0);
+  }
+
+  // New states of an upper group are saturated again by all lower groups
+  size_t group = 0;
+  while (group < groups.size()) {
+    if (zero_fixpoint(groups[group], fw, all_layers, expanded, all_reached,
+                      maxNodes, initialization) &&
+        group > 0) {
+      group = 0;
+    } else {
+      ++group;
+    }
+  }
+  layers.insert(layers.end(), all_layers.begin() + 1, all_layers.end());
+}
+
+bool SymStateSpaceManager::nodesExceeded() const {
+  return vars->get_manager()->ReadErrorCode() == CUDD_TOO_MANY_NODES;
+}
+
+bool SymStateSpaceManager::split(const BDD &bdd, BDD &part1,
+                                 BDD &part2) const {
+  int best_var = -1;
+  int best_size = numeric_limits<int>::max();
+  for (unsigned int var : bdd.SupportIndices()) {
+    // Skip variables with a constant value in all states
+    if (bdd.IsVarEssential(var, 0) || bdd.IsVarEssential(var, 1)) {
+      continue;
+    }
+    int size =
+        max(bdd.EstimateCofactor(var, 0), bdd.EstimateCofactor(var, 1));
+    if (size < best_size) {
+      best_size = size;
+      best_var = var;
+    }
+  }
+  if (best_var == -1) {
+    return false;
+  }
+
+  BDD var_bdd = vars->get_manager()->bddVar(best_var);
+  part1 = bdd * var_bdd;
+  part2 = bdd * !var_bdd;
+  return true;
+}
+
+static const int MUTEX_REORDER_INTERVAL = 32;
+
+// Prunings per second, mutex BDDs that were never applied come first
+static double pruning_power(const MutexFilterStats &stats) {
+  if (stats.applications == 0) {
+    return numeric_limits<double>::infinity();
+  }
+  return stats.prunings / max(stats.time, 1e-9);
+}
+
+BDD SymStateSpaceManager::filter_mutex_simplified(const BDD &bdd, bool fw,
+                                                  int nodeLimit) {
+  const vector<BDD> &notMutexBDDs = (fw ? notMutexBDDsFw : notMutexBDDsBw);
+  vector<size_t> &order = fw ? mutex_order_fw : mutex_order_bw;
+  vector<MutexFilterStats> &stats = fw ? mutex_stats_fw : mutex_stats_bw;
+  if (order.size() != notMutexBDDs.size()) {
+    order.resize(notMutexBDDs.size());
+    iota(order.begin(), order.end(), 0);
+    stats.assign(notMutexBDDs.size(), MutexFilterStats());
+  }
+
+  BDD res = bdd;
+  for (size_t i : order) {
+    if (res.IsZero()) {
+      break;
+    }
+    utils::Timer timer;
+    // The simplified BDD agrees with the mutex BDD on res, so the
+    // conjunction is exact
+    BDD simplified = p.mutex_type == MutexType::MUTEX_RESTRICT
+                         ? notMutexBDDs[i].Restrict(res)
+                         : notMutexBDDs[i].Constrain(res);
+    if (simplified.IsOne()) {
+      ++num_mutex_skipped;
+    } else {
+      BDD filtered = res.And(simplified, nodeLimit);
+      if (filtered != res) {
+        ++stats[i].prunings;
+      }
+      res = filtered;
+      ++num_mutex_conjunctions;
+    }
+    ++stats[i].applications;
+    stats[i].time += timer();
+  }
+
+  if (++num_filterings % MUTEX_REORDER_INTERVAL == 0) {
+    for (vector<size_t> *dir_order : {&mutex_order_fw, &mutex_order_bw}) {
+      const vector<MutexFilterStats> &dir_stats =
+          dir_order == &mutex_order_fw ? mutex_stats_fw : mutex_stats_bw;
+      stable_sort(dir_order->begin(), dir_order->end(),
+                  [&dir_stats](size_t a, size_t b) {
+                    return pruning_power(dir_stats[a]) >
+                           pruning_power(dir_stats[b]);
+                  });
+    }
+  }
+  return res;
+}
+
 BDD SymStateSpaceManager::filter_mutex(const BDD &bdd, bool fw, int nodeLimit,
                                        bool initialization) {
+  utils::Timer timer;
   BDD res = bdd;
   const vector<BDD> &notDeadEndBDDs = fw ? notDeadEndFw : notDeadEndBw;
   for (const BDD &notDeadEnd : notDeadEndBDDs) {
@@ -116,11 +335,24 @@ BDD SymStateSpaceManager::filter_mutex(const BDD &bdd, bool fw, int nodeLimit,
     for (const BDD &notMutexBDD : notMutexBDDs) {
       res = res.And(notMutexBDD, nodeLimit);
     }
+    num_mutex_conjunctions += notMutexBDDs.size();
+    break;
+  case MutexType::MUTEX_RESTRICT:
+  case MutexType::MUTEX_CONSTRAIN:
+    res = filter_mutex_simplified(res, fw, nodeLimit);
     break;
   }
+  filter_time += timer();
   return res;
 }
 
+void SymStateSpaceManager::print_filter_statistics() const {
+  cout << "Mutex filter time: " << filter_time << "s" << endl;
+  cout << "Image time: " << image_time << "s" << endl;
+  cout << "Mutex conjunctions: " << num_mutex_conjunctions
+       << ", skipped: " << num_mutex_skipped << endl;
+}
+
 int SymStateSpaceManager::filterMutexBucket(vector<BDD> &bucket, bool fw,
                                             bool initialization, int maxTime,
                                             int maxNodes) {
@@ -138,10 +370,10 @@ int SymStateSpaceManager::filterMutexBucket(vector<BDD> &bucket, bool fw,
   return numFiltered;
 }
 
-void SymStateSpaceManager::filterMutex(Bucket &bucket, bool fw,
-                                       bool initialization) {
-  filterMutexBucket(bucket, fw, initialization, p.max_aux_time,
-                    p.max_aux_nodes);
+int SymStateSpaceManager::filterMutex(Bucket &bucket, bool fw,
+                                      bool initialization) {
+  return filterMutexBucket(bucket, fw, initialization, p.max_aux_time,
+                           p.max_aux_nodes);
 }
 
 void SymStateSpaceManager::mergeBucket(Bucket &bucket) const {
@@ -155,17 +387,27 @@ void SymStateSpaceManager::mergeBucketAnd(Bucket &bucket) const {
 void SymStateSpaceManager::init_transitions(
     const map<int, vector<TransitionRelation>> &(indTRs)) {
   transitions = indTRs; // Copy
+  for (map<int, vector<TransitionRelation>>::iterator it = transitions.begin();
+       it != transitions.end(); ++it) {
+    merge(vars, it->second, mergeTR, p.max_tr_time, p.max_tr_size);
+  }
+  init_transition_costs();
+}
+
+void SymStateSpaceManager::set_transitions(
+    map<int, vector<TransitionRelation>> &&trs) {
+  transitions = move(trs);
+  init_transition_costs();
+}
+
+void SymStateSpaceManager::init_transition_costs() {
+  init_cost_trs();
   if (transitions.empty()) {
     hasTR0 = false;
     min_transition_cost = 1;
     return;
   }
 
-  for (map<int, vector<TransitionRelation>>::iterator it = transitions.begin();
-       it != transitions.end(); ++it) {
-    merge(vars, it->second, mergeTR, p.max_tr_time, p.max_tr_size);
-  }
-
   min_transition_cost = transitions.begin()->first;
   if (min_transition_cost == 0) {
     hasTR0 = true;
@@ -175,12 +417,68 @@ void SymStateSpaceManager::init_transitions(
   }
 }
 
+BDD SymStateSpaceManager::get_cost_cube(size_t cost_index) const {
+  BDD cube = oneBDD();
+  for (size_t bit = 0; bit < cost_vars.size(); ++bit) {
+    if ((cost_index >> (cost_vars.size() - 1 - bit)) & 1) {
+      cube *= cost_vars[bit];
+    } else {
+      cube *= !cost_vars[bit];
+    }
+  }
+  return cube;
+}
+
+void SymStateSpaceManager::init_cost_trs() {
+  cost_trs.clear();
+  cost_values.clear();
+  for (const auto &trs : transitions) {
+    if (trs.first != 0) {
+      cost_values.push_back(trs.first);
+    }
+  }
+  if ((int)cost_values.size() <= p.max_cost_groups) {
+    cost_values.clear();
+    return;
+  }
+
+  utils::Timer timer;
+  int num_bits = 0;
+  while ((size_t(1) << num_bits) < cost_values.size()) {
+    ++num_bits;
+  }
+  cost_vars = vars->get_aux_vars(num_bits);
+  for (size_t i = 0; i < cost_values.size(); ++i) {
+    BDD cube = get_cost_cube(i);
+    for (const TransitionRelation &tr : transitions.at(cost_values[i])) {
+      // Cost -1: the cost is encoded in the BDD
+      cost_trs.emplace_back(vars, tr.getBDD() * cube, tr.getEffVars(), -1,
+                            tr.getOpsIds());
+    }
+  }
+  // TRs with the same support are merged first
+  stable_sort(cost_trs.begin(), cost_trs.end(),
+              [](const TransitionRelation &tr1, const TransitionRelation &tr2) {
+                return tr1.getEffVars() < tr2.getEffVars();
+              });
+  merge(vars, cost_trs, mergeTR, p.max_tr_time, p.max_tr_size);
+  cout << "Encoded " << cost_values.size() << " costs in " << num_bits
+       << " BDD variables: " << cost_trs.size() << " TRs, "
+       << timer << endl;
+}
+
 SymParamsMgr::SymParamsMgr(const options::Options &opts)
     : max_tr_size(opts.get<int>("max_tr_size")),
       max_tr_time(opts.get<int>("max_tr_time")),
+      max_cost_groups(opts.get<int>("max_cost_groups")),
+      tr_threads(opts.get<int>("tr_threads")),
+      tr_cache(opts.contains("tr_cache") ? opts.get<string>("tr_cache") : ""),
       mutex_type(MutexType(opts.get_enum("mutex_type"))),
       max_mutex_size(opts.get<int>("max_mutex_size")),
       max_mutex_time(opts.get<int>("max_mutex_time")),
+      zero_cost_expansion(
+          ZeroCostExpansion(opts.get_enum("zero_cost_expansion"))),
+      max_image_splits(opts.get<int>("max_image_splits")),
       max_aux_nodes(opts.get<int>("max_aux_nodes")),
       max_aux_time(opts.get<int>("max_aux_time")) {
   // Don't use edeletion with conditional effects
@@ -195,9 +493,11 @@ SymParamsMgr::SymParamsMgr(const options::Options &opts)
 }
 
 SymParamsMgr::SymParamsMgr()
-    : max_tr_size(100000), max_tr_time(60000),
+    : max_tr_size(100000), max_tr_time(60000), max_cost_groups(16),
+      tr_threads(1),
       mutex_type(MutexType::MUTEX_EDELETION), max_mutex_size(100000),
-      max_mutex_time(60000), max_aux_nodes(1000000), max_aux_time(2000) {
+      max_mutex_time(60000), zero_cost_expansion(ZeroCostExpansion::BFS),
+      max_image_splits(0), max_aux_nodes(1000000), max_aux_time(2000) {
   // Don't use edeletion with conditional effects
   TaskProxy task_proxy(*tasks::g_root_task);
   if (mutex_type == MutexType::MUTEX_EDELETION &&
@@ -210,19 +510,58 @@ SymParamsMgr::SymParamsMgr()
 }
 
 void SymParamsMgr::print_options() const {
-  cout << "TR(time=" << max_tr_time << ", nodes=" << max_tr_size << ")" << endl;
+  cout << "TR(time=" << max_tr_time << ", nodes=" << max_tr_size
+       << ", threads=" << tr_threads << ", cost groups=" << max_cost_groups
+       << ")" << endl;
+  if (!tr_cache.empty()) {
+    cout << "TR cache: " << tr_cache << endl;
+  }
   cout << "Mutex(time=" << max_mutex_time << ", nodes=" << max_mutex_size
        << ", type=" << mutex_type << ")" << endl;
+  cout << "Zero-cost expansion: " << zero_cost_expansion << endl;
+  cout << "Image splits: " << max_image_splits << endl;
   cout << "Aux(time=" << max_aux_time << ", nodes=" << max_aux_nodes << ")"
        << endl;
 }
 
+bool SymParamsMgr::same_state_space(const SymParamsMgr &other) const {
+  return max_tr_size == other.max_tr_size &&
+         max_tr_time == other.max_tr_time &&
+         max_cost_groups == other.max_cost_groups &&
+         mutex_type == other.mutex_type &&
+         max_mutex_size == other.max_mutex_size &&
+         max_mutex_time == other.max_mutex_time &&
+         zero_cost_expansion == other.zero_cost_expansion &&
+         max_image_splits == other.max_image_splits &&
+         max_aux_nodes == other.max_aux_nodes &&
+         max_aux_time == other.max_aux_time;
+}
+
 void SymParamsMgr::add_options_to_parser(options::OptionParser &parser) {
   parser.add_option<int>("max_tr_size", "maximum size of TR BDDs", "100000");
 
   parser.add_option<int>("max_tr_time", "maximum time (ms) to generate TR BDDs",
                          "60000");
 
+  parser.add_option<int>(
+      "max_cost_groups",
+      "maximum number of distinct non-zero action costs with one group of TRs "
+      "each. Tasks with more costs use TRs that encode the cost in auxiliary "
+      "BDD variables, so that one image computes the successors of all costs",
+      "16", options::Bounds("0", "infinity"));
+
+  parser.add_option<int>("tr_threads",
+                         "number of threads that build the TRs of the "
+                         "operators, each on its own BDD manager",
+                         "1", options::Bounds("1", "infinity"));
+
+  parser.add_option<string>(
+      "tr_cache",
+      "directory of a persistent cache of the TRs. Entries are keyed by the "
+      "task, the variable order and the TR and mutex parameters, so reruns "
+      "on the same task skip the construction of the TRs",
+      options::OptionParser::NONE);
+
   parser.add_enum_option("mutex_type", MutexTypeValues, "mutex type",
                          "MUTEX_EDELETION");
 
@@ -232,6 +571,17 @@ void SymParamsMgr::add_options_to_parser(options::OptionParser &parser) {
   parser.add_option<int>("max_mutex_time",
                          "maximum time (ms) to generate mutex BDDs", "60000");
 
+  parser.add_enum_option("zero_cost_expansion", ZeroCostExpansionValues,
+                         "expansion of zero-cost transitions: one image per "
+                         "step or fixpoint by chaining or saturation",
+                         "BFS");
+
+  parser.add_option<int>("max_image_splits",
+                         "maximum number of times the frontier is split into "
+                         "disjoint parts in a step if an image exceeds the "
+                         "node limit (0 disables splitting)",
+                         "0");
+
   parser.add_option<int>("max_aux_nodes", "maximum size in pop operations",
                          "1000000");
   parser.add_option<int>("max_aux_time", "maximum time (ms) in pop operations",
@@ -12,6 +12,7 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <string>
 #include <vector>
 
 namespace options {
@@ -31,11 +32,24 @@ class SymParamsMgr {
 public:
   // Parameters to generate the TRs
   int max_tr_size, max_tr_time;
+  // Tasks with more distinct non-zero costs use TRs with encoded costs
+  int max_cost_groups;
+  // Threads that build the TRs of the operators
+  int tr_threads;
+  // Directory of the persistent TR cache (empty if disabled)
+  std::string tr_cache;
 
   // Parameters to generate the mutex BDDs
   MutexType mutex_type;
   int max_mutex_size, max_mutex_time;
 
+  // Expansion of zero-cost transitions
+  ZeroCostExpansion zero_cost_expansion;
+
+  // Maximum number of frontier splits in a step if an image exceeds the
+  // node limit
+  int max_image_splits;
+
   // Time and memory bounds for auxiliary operations
   int max_aux_nodes, max_aux_time;
 
@@ -43,9 +57,69 @@ public:
   SymParamsMgr(const options::Options &opts);
   static void add_options_to_parser(options::OptionParser &parser);
   void print_options() const;
+
+  // True if all parameters are equal, except the ones that only affect how
+  // the TRs are built (threads and cache)
+  bool same_state_space(const SymParamsMgr &other) const;
+};
+
+// Time and size of the result of an image with a single TR
+struct ImageStats {
+  int cost;
+  int tr; // Index of the TR among the TRs of the same cost
+  double time;
+  int nodes;
+};
+
+// Measured pruning power of a mutex BDD
+struct MutexFilterStats {
+  long applications = 0;
+  long prunings = 0; // Applications that removed states
+  double time = 0;   // s
 };
 
 class SymStateSpaceManager {
+  // Image statistics are only recorded if set (for tracing)
+  std::vector<ImageStats> *image_stats;
+
+  // Total time (s) of the mutex filtering and the images
+  double filter_time;
+  mutable double image_time;
+  // Conjunctions with mutex BDDs that were skipped because the simplified
+  // mutex BDD was one (MUTEX_RESTRICT and MUTEX_CONSTRAIN)
+  long num_mutex_conjunctions, num_mutex_skipped;
+
+  // Order in which the mutex BDDs are applied (MUTEX_RESTRICT and
+  // MUTEX_CONSTRAIN), updated every MUTEX_REORDER_INTERVAL filterings
+  std::vector<size_t> mutex_order_fw, mutex_order_bw;
+  std::vector<MutexFilterStats> mutex_stats_fw, mutex_stats_bw;
+  int num_filterings;
+
+  BDD filter_mutex_simplified(const BDD &bdd, bool fw, int nodeLimit);
+
+  BDD traced_image(const TransitionRelation &tr, int id, const BDD &bdd,
+                   bool fw, int nodeLimit) const;
+
+  /*
+   * TRs of all non-zero costs with the index of the cost (in cost_values)
+   * encoded in auxiliary BDD variables (cost_vars, most significant bit
+   * first). They are merged by support instead of by cost, and one image
+   * computes the successors of all costs, which are then partitioned by
+   * cost. Only used if the task has more than max_cost_groups distinct
+   * non-zero costs, empty otherwise.
+   */
+  std::vector<TransitionRelation> cost_trs;
+  std::vector<int> cost_values;
+  std::vector<BDD> cost_vars;
+
+  void init_cost_trs();
+  BDD get_cost_cube(size_t cost_index) const;
+  void encoded_cost_image(const BDD &bdd, bool fw,
+                          std::map<int, std::vector<BDD>> &res,
+                          int maxNodes) const;
+  void partition_by_cost(const BDD &bdd, size_t bit, size_t cost_index,
+                         std::map<int, std::vector<BDD>> &res) const;
+
   void zero_preimage(const BDD &bdd, std::vector<BDD> &res, int maxNodes) const;
   void cost_preimage(const BDD &bdd, std::map<int, std::vector<BDD>> &res,
                      int maxNodes) const;
@@ -53,6 +127,12 @@ class SymStateSpaceManager {
   void cost_image(const BDD &bdd, std::map<int, std::vector<BDD>> &res,
                   int maxNodes) const;
 
+  // Applies the zero-cost TRs in trs_ids until no new state is reached.
+  // For each TR, only layers that have not been expanded by it are used.
+  bool zero_fixpoint(const std::vector<size_t> &trs_ids, bool fw,
+                     std::vector<BDD> &layers, std::vector<size_t> &expanded,
+                     BDD &reached, int maxNodes, bool initialization);
+
 protected:
   SymVariables *vars;
   const SymParamsMgr p;
@@ -82,6 +162,9 @@ protected:
 
   void init_transitions(
       const std::map<int, std::vector<TransitionRelation>> &(indTRs));
+  // Uses already merged TRs, e.g., loaded from the TR cache
+  void set_transitions(std::map<int, std::vector<TransitionRelation>> &&trs);
+  void init_transition_costs();
 
 public:
   SymStateSpaceManager(SymVariables *v, const SymParamsMgr &params,
@@ -89,7 +172,8 @@ public:
 
   virtual ~SymStateSpaceManager() {}
 
-  void filterMutex(Bucket &bucket, bool fw, bool initialization);
+  // Returns the number of filtered BDDs (at the front of bucket)
+  int filterMutex(Bucket &bucket, bool fw, bool initialization);
   void mergeBucket(Bucket &bucket) const;
   void mergeBucketAnd(Bucket &bucket) const;
 
@@ -158,6 +242,10 @@ public:
     return hasTR0;
   }
 
+  const std::map<int, std::vector<TransitionRelation>> &getTransitions() const {
+    return transitions;
+  }
+
   void zero_image(bool fw, const BDD &bdd, std::vector<BDD> &res,
                   int maxNodes) {
     if (fw) {
@@ -176,11 +264,36 @@ public:
     }
   }
 
+  /*
+   * Computes all states reachable from bdd with zero-cost transitions
+   * (without the reached states) with chaining or saturation. Each new
+   * layer only contains states with a predecessor in bdd or a previous
+   * layer, which is required for plan reconstruction.
+   */
+  void zero_closure(bool fw, const BDD &bdd, const BDD &reached,
+                    std::vector<BDD> &layers, int maxNodes,
+                    bool initialization);
+
   BDD filter_mutex(const BDD &bdd, bool fw, int maxNodes, bool initialization);
 
+  // True if the last BDD operation failed because of the node limit
+  bool nodesExceeded() const;
+
+  /*
+   * Splits bdd into two disjoint parts by cofactoring on the variable
+   * with the most balanced (estimated) cofactor sizes. Returns false if
+   * bdd cannot be split, i.e., it represents a single state.
+   */
+  bool split(const BDD &bdd, BDD &part1, BDD &part2) const;
+
   int filterMutexBucket(std::vector<BDD> &bucket, bool fw, bool initialization,
                         int maxTime, int maxNodes);
 
+  // Time of the mutex filtering vs. time of the images
+  void print_filter_statistics() const;
+
+  void set_image_stats(std::vector<ImageStats> *stats) { image_stats = stats; }
+
   void setTimeLimit(int maxTime) { vars->setTimeLimit(maxTime); }
 
   void unsetTimeLimit() { vars->unsetTimeLimit(); }
@@ -0,0 +1,361 @@
+#include "sym_tr_cache.h"
+
+#include "sym_state_space_manager.h"
+#include "sym_variables.h"
+
+#include "../abstract_task.h"
+#include "../mutex_group.h"
+#include "../tasks/root_task.h"
+#include "../utils/hash.h"
+#include "../utils/system.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <sys/stat.h>
+#include <sys/types.h>
+#elif OPERATING_SYSTEM == WINDOWS
+#include <direct.h>
+#endif
+
+using namespace std;
+
+namespace symbolic {
+static const char TR_CACHE_MAGIC[8] = "SYMTR";
+// Increase when the key or the entry format changes
+static const int32_t TR_CACHE_VERSION = 1;
+
+struct TRCacheHeader {
+  char magic[8];
+  int32_t version;
+  int32_t num_bdd_vars;
+  uint64_t key;
+  // Followed by the number of nodes, the nodes (index, then, else) and the
+  // individual and merged TRs (cost, root, effect variables, operators)
+};
+
+static void feed_fact(utils::HashState &hash_state, const FactPair &fact) {
+  utils::feed(hash_state, fact.var);
+  utils::feed(hash_state, fact.value);
+}
+
+static void feed_operators(utils::HashState &hash_state,
+                           const AbstractTask &task, bool is_axiom) {
+  int num_ops = is_axiom ? task.get_num_axioms() : task.get_num_operators();
+  utils::feed(hash_state, num_ops);
+  for (int op = 0; op < num_ops; ++op) {
+    utils::feed(hash_state, task.get_operator_cost(op, is_axiom));
+    int num_pres = task.get_num_operator_preconditions(op, is_axiom);
+    utils::feed(hash_state, num_pres);
+    for (int i = 0; i < num_pres; ++i) {
+      feed_fact(hash_state, task.get_operator_precondition(op, i, is_axiom));
+    }
+    int num_effs = task.get_num_operator_effects(op, is_axiom);
+    utils::feed(hash_state, num_effs);
+    for (int eff = 0; eff < num_effs; ++eff) {
+      feed_fact(hash_state, task.get_operator_effect(op, eff, is_axiom));
+      int num_conds =
+          task.get_num_operator_effect_conditions(op, eff, is_axiom);
+      utils::feed(hash_state, num_conds);
+      for (int i = 0; i < num_conds; ++i) {
+        feed_fact(hash_state,
+                  task.get_operator_effect_condition(op, eff, i, is_axiom));
+      }
+    }
+  }
+}
+
+// Everything the TRs depend on, i.e., not the initial state and the goals
+static uint64_t compute_key(const SymVariables &vars,
+                            const SymParamsMgr &params) {
+  const AbstractTask &task = *tasks::g_root_task;
+  utils::HashState hash_state;
+  utils::feed(hash_state, TR_CACHE_VERSION);
+
+  utils::feed(hash_state, task.get_num_variables());
+  for (int var = 0; var < task.get_num_variables(); ++var) {
+    utils::feed(hash_state, task.get_variable_domain_size(var));
+    utils::feed(hash_state, task.get_variable_axiom_layer(var));
+    utils::feed(hash_state, task.get_variable_default_axiom_value(var));
+  }
+  feed_operators(hash_state, task, false);
+  feed_operators(hash_state, task, true);
+
+  vector<MutexGroup> mutex_groups = task.get_mutex_groups();
+  utils::feed(hash_state, static_cast<int>(mutex_groups.size()));
+  for (const MutexGroup &group : mutex_groups) {
+    utils::feed(hash_state, static_cast<int>(group.getFacts().size()));
+    for (const FactPair &fact : group.getFacts()) {
+      feed_fact(hash_state, fact);
+    }
+    utils::feed(hash_state, static_cast<int>(group.isExactlyOne()));
+    utils::feed(hash_state, static_cast<int>(group.pruneFW()));
+  }
+
+  for (int var : vars.get_var_order()) {
+    utils::feed(hash_state, var);
+  }
+  utils::feed(hash_state, static_cast<int>(params.mutex_type));
+  utils::feed(hash_state, params.max_mutex_size);
+  utils::feed(hash_state, params.max_mutex_time);
+  utils::feed(hash_state, params.max_tr_size);
+  utils::feed(hash_state, params.max_tr_time);
+  return hash_state.get_hash64();
+}
+
+static void create_directory(const string &dir) {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+  int res = mkdir(dir.c_str(), 0777);
+#elif OPERATING_SYSTEM == WINDOWS
+  int res = _mkdir(dir.c_str());
+#endif
+  if (res != 0 && errno != EEXIST) {
+    cerr << "Warning: could not create TR cache directory " << dir << ": "
+         << strerror(errno) << endl;
+  }
+}
+
+namespace {
+// Serializes BDDs as a table of shared nodes. Node 0 is the constant one
+// and a reference to a node is 2 * id + complemented.
+class BDDNodeWriter {
+  unordered_map<DdNode *, int32_t> ids;
+  int32_t num_nodes;
+
+public:
+  vector<int32_t> nodes;
+
+  BDDNodeWriter() : num_nodes(1) {}
+
+  int32_t add(DdNode *node) {
+    DdNode *regular = Cudd_Regular(node);
+    int32_t complemented = Cudd_IsComplement(node) ? 1 : 0;
+    if (Cudd_IsConstant(regular)) {
+      return complemented;
+    }
+    auto it = ids.find(regular);
+    if (it != ids.end()) {
+      return 2 * it->second + complemented;
+    }
+    // Children are stored first, so nodes can be loaded in order
+    int32_t then_ref = add(Cudd_T(regular));
+    int32_t else_ref = add(Cudd_E(regular));
+    nodes.push_back(Cudd_NodeReadIndex(regular));
+    nodes.push_back(then_ref);
+    nodes.push_back(else_ref);
+    int32_t id = num_nodes++;
+    ids[regular] = id;
+    return 2 * id + complemented;
+  }
+};
+
+class EntryReader {
+  const vector<int32_t> &data;
+  size_t pos;
+
+public:
+  explicit EntryReader(const vector<int32_t> &data) : data(data), pos(0) {}
+
+  // Throws if the entry is truncated
+  int32_t next() {
+    if (pos == data.size()) {
+      throw out_of_range("truncated entry");
+    }
+    return data[pos++];
+  }
+
+  bool done() const { return pos == data.size(); }
+};
+} // namespace
+
+static void write_trs(const map<int, vector<TransitionRelation>> &trs,
+                      BDDNodeWriter &node_writer, vector<int32_t> &out) {
+  int num_trs = 0;
+  for (const auto &cost_trs : trs) {
+    num_trs += cost_trs.second.size();
+  }
+  out.push_back(num_trs);
+  for (const auto &cost_trs : trs) {
+    for (const TransitionRelation &tr : cost_trs.second) {
+      out.push_back(cost_trs.first);
+      out.push_back(node_writer.add(tr.getBDD().getNode()));
+      out.push_back(tr.getEffVars().size());
+      out.insert(out.end(), tr.getEffVars().begin(), tr.getEffVars().end());
+      out.push_back(tr.getOpsIds().size());
+      for (const OperatorID &op_id : tr.getOpsIds()) {
+        out.push_back(op_id.get_index());
+      }
+    }
+  }
+}
+
+static void read_trs(EntryReader &reader, const vector<BDD> &nodes,
+                     SymVariables *vars,
+                     map<int, vector<TransitionRelation>> &trs) {
+  int num_ops = tasks::g_root_task->get_num_operators();
+  int num_fd_vars = tasks::g_root_task->get_num_variables();
+  int num_trs = reader.next();
+  for (int i = 0; i < num_trs; ++i) {
+    int cost = reader.next();
+    size_t root = reader.next();
+    if (root / 2 >= nodes.size()) {
+      throw out_of_range("invalid root");
+    }
+    BDD tBDD = root % 2 ? !nodes[root / 2] : nodes[root / 2];
+    int num_eff_vars = reader.next();
+    if (num_eff_vars < 0 || num_eff_vars > num_fd_vars) {
+      throw out_of_range("invalid number of variables");
+    }
+    vector<int> eff_vars(num_eff_vars);
+    for (int &var : eff_vars) {
+      var = reader.next();
+      if (var < 0 || var >= num_fd_vars) {
+        throw out_of_range("invalid variable");
+      }
+    }
+    set<OperatorID> ops_ids;
+    int num_tr_ops = reader.next();
+    for (int j = 0; j < num_tr_ops; ++j) {
+      int op = reader.next();
+      if (op < 0 || op >= num_ops) {
+        throw out_of_range("invalid operator");
+      }
+      ops_ids.insert(OperatorID(op));
+    }
+    trs[cost].emplace_back(vars, tBDD, eff_vars, cost, ops_ids);
+  }
+}
+
+SymTRCache::SymTRCache(const string &dir, const SymVariables &vars,
+                       const SymParamsMgr &params)
+    : dir(dir), key(compute_key(vars, params)),
+      // Only the state variables, not auxiliary ones
+      num_bdd_vars(vars.getBDDVarsPre().size() + vars.getBDDVarsEff().size()) {
+}
+
+string SymTRCache::get_filename() const {
+  ostringstream name;
+  name << dir << "/" << hex << setw(16) << setfill('0') << key << ".symtr";
+  return name.str();
+}
+
+bool SymTRCache::load(SymVariables *vars,
+                      map<int, vector<TransitionRelation>> &ind_trs,
+                      map<int, vector<TransitionRelation>> &trs) const {
+  string filename = get_filename();
+  ifstream file(filename, ios::binary);
+  if (!file) {
+    return false;
+  }
+  TRCacheHeader header;
+  vector<int32_t> data;
+  if (file.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    file.seekg(0, ios::end);
+    streamoff size = static_cast<streamoff>(file.tellg()) - sizeof(header);
+    file.seekg(sizeof(header));
+    data.resize(size / sizeof(int32_t));
+    file.read(reinterpret_cast<char *>(data.data()),
+              data.size() * sizeof(int32_t));
+  }
+  if (!file || memcmp(header.magic, TR_CACHE_MAGIC, 8) != 0 ||
+      header.version != TR_CACHE_VERSION || header.key != key ||
+      header.num_bdd_vars != num_bdd_vars) {
+    cout << "TR cache entry " << filename << " is invalid, ignoring it"
+         << endl;
+    return false;
+  }
+
+  try {
+    EntryReader reader(data);
+    Cudd &manager = *vars->get_manager();
+    int num_nodes = reader.next();
+    if (num_nodes < 0 || static_cast<size_t>(num_nodes) > data.size() / 3) {
+      throw out_of_range("invalid number of nodes");
+    }
+    vector<BDD> nodes;
+    nodes.reserve(num_nodes + 1);
+    nodes.push_back(manager.bddOne());
+    for (int i = 0; i < num_nodes; ++i) {
+      int index = reader.next();
+      size_t then_ref = reader.next();
+      size_t else_ref = reader.next();
+      if (index < 0 || index >= num_bdd_vars ||
+          then_ref / 2 >= nodes.size() || else_ref / 2 >= nodes.size()) {
+        throw out_of_range("invalid node");
+      }
+      BDD then_bdd =
+          then_ref % 2 ? !nodes[then_ref / 2] : nodes[then_ref / 2];
+      BDD else_bdd =
+          else_ref % 2 ? !nodes[else_ref / 2] : nodes[else_ref / 2];
+      nodes.push_back(vars->bddVar(index).Ite(then_bdd, else_bdd));
+    }
+    read_trs(reader, nodes, vars, ind_trs);
+    read_trs(reader, nodes, vars, trs);
+    if (!reader.done()) {
+      throw out_of_range("trailing data");
+    }
+  } catch (const out_of_range &err) {
+    cout << "TR cache entry " << filename << " is invalid (" << err.what()
+         << "), ignoring it" << endl;
+    ind_trs.clear();
+    trs.clear();
+    return false;
+  }
+  return true;
+}
+
+void SymTRCache::store(
+    const map<int, vector<TransitionRelation>> &ind_trs,
+    const map<int, vector<TransitionRelation>> &trs) const {
+  BDDNodeWriter node_writer;
+  vector<int32_t> tr_data;
+  write_trs(ind_trs, node_writer, tr_data);
+  write_trs(trs, node_writer, tr_data);
+
+  TRCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, TR_CACHE_MAGIC, sizeof(TR_CACHE_MAGIC));
+  header.version = TR_CACHE_VERSION;
+  header.num_bdd_vars = num_bdd_vars;
+  header.key = key;
+  int32_t num_nodes = node_writer.nodes.size() / 3;
+
+  create_directory(dir);
+  string filename = get_filename();
+  string tmp_filename =
+      filename + ".tmp-" + to_string(utils::get_process_id());
+  {
+    ofstream file(tmp_filename, ios::binary);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(&num_nodes), sizeof(num_nodes));
+    file.write(reinterpret_cast<const char *>(node_writer.nodes.data()),
+               node_writer.nodes.size() * sizeof(int32_t));
+    file.write(reinterpret_cast<const char *>(tr_data.data()),
+               tr_data.size() * sizeof(int32_t));
+    if (!file) {
+      cerr << "Warning: could not write TR cache entry " << tmp_filename
+           << endl;
+      file.close();
+      remove(tmp_filename.c_str());
+      return;
+    }
+  }
+  // Atomic on POSIX; fails on Windows if another planner stored the entry
+  if (rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+    cerr << "Warning: could not store TR cache entry " << filename << endl;
+    remove(tmp_filename.c_str());
+    return;
+  }
+  cout << "TR cache entry stored: " << filename << " (" << num_nodes
+       << " nodes)" << endl;
+}
+} // namespace symbolic
@@ -0,0 +1,46 @@
+#ifndef SYMBOLIC_SYM_TR_CACHE_H
+#define SYMBOLIC_SYM_TR_CACHE_H
+
+#include "transition_relation.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace symbolic {
+class SymParamsMgr;
+class SymVariables;
+
+/*
+ * Persistent cache of the individual and merged TRs of the original state
+ * space. Each entry is a file in the cache directory, keyed by a hash of the
+ * task, the variable order and the parameters used to generate the TRs and
+ * mutexes. The BDDs of all TRs of an entry are stored as one table of shared
+ * nodes, so loading an entry only needs one ITE per node.
+ *
+ * Entries are written to a temporary file and renamed into place, so several
+ * planners may share a cache directory.
+ */
+class SymTRCache {
+  std::string dir;
+  std::uint64_t key;
+  int num_bdd_vars;
+
+  std::string get_filename() const;
+
+public:
+  SymTRCache(const std::string &dir, const SymVariables &vars,
+             const SymParamsMgr &params);
+
+  // Returns false if there is no valid entry for the task
+  bool load(SymVariables *vars,
+            std::map<int, std::vector<TransitionRelation>> &ind_trs,
+            std::map<int, std::vector<TransitionRelation>> &trs) const;
+
+  void store(const std::map<int, std::vector<TransitionRelation>> &ind_trs,
+             const std::map<int, std::vector<TransitionRelation>> &trs) const;
+};
+} // namespace symbolic
+
+#endif
@@ -0,0 +1,119 @@
+#include "sym_trace.h"
+
+#include "../utils/system.h"
+
+#include "cuddObj.hh"
+
+#include <cmath>
+#include <iomanip>
+
+using namespace std;
+
+namespace symbolic {
+
+// Records are written to the file once the buffer exceeds this size
+static const size_t MAX_BUFFER_SIZE = 1 << 20;
+
+SymTraceRecord::SymTraceRecord() : empty(true) {
+  json << setprecision(6);
+}
+
+ostream &SymTraceRecord::key(const string &name) {
+  if (!empty) {
+    json << ",";
+  }
+  empty = false;
+  return json << "\"" << name << "\":";
+}
+
+SymTraceRecord &SymTraceRecord::add(const string &name, const string &value) {
+  key(name) << "\"" << value << "\"";
+  return *this;
+}
+
+SymTraceRecord &SymTraceRecord::add(const string &name, const char *value) {
+  return add(name, string(value));
+}
+
+SymTraceRecord &SymTraceRecord::add(const string &name, bool value) {
+  key(name) << (value ? "true" : "false");
+  return *this;
+}
+
+SymTraceRecord &SymTraceRecord::add(const string &name, int value) {
+  key(name) << value;
+  return *this;
+}
+
+SymTraceRecord &SymTraceRecord::add(const string &name, long value) {
+  key(name) << value;
+  return *this;
+}
+
+SymTraceRecord &SymTraceRecord::add(const string &name, double value) {
+  // JSON has no representation of infinity and NaN
+  if (isfinite(value)) {
+    key(name) << value;
+  } else {
+    key(name) << "null";
+  }
+  return *this;
+}
+
+SymTraceRecord &SymTraceRecord::add(const string &name,
+                                    const SymTraceRecord &object) {
+  key(name) << object.str();
+  return *this;
+}
+
+SymTraceRecord &SymTraceRecord::add(const string &name,
+                                    const vector<SymTraceRecord> &array) {
+  ostream &os = key(name);
+  os << "[";
+  for (size_t i = 0; i < array.size(); ++i) {
+    if (i > 0) {
+      os << ",";
+    }
+    os << array[i].str();
+  }
+  os << "]";
+  return *this;
+}
+
+string SymTraceRecord::str() const { return "{" + json.str() + "}"; }
+
+SymTrace::SymTrace(const string &filename) : file(filename) {
+  if (!file) {
+    cerr << "Error: could not open trace file " << filename << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+  }
+  buffer.reserve(MAX_BUFFER_SIZE);
+}
+
+SymTrace::~SymTrace() { flush(); }
+
+void SymTrace::write(const SymTraceRecord &record) {
+  buffer += record.str();
+  buffer += '\n';
+  if (buffer.size() >= MAX_BUFFER_SIZE) {
+    flush();
+  }
+}
+
+void SymTrace::flush() {
+  file << buffer;
+  file.flush();
+  buffer.clear();
+}
+
+SymTraceRecord SymTrace::cudd_stats(const Cudd &manager) {
+  SymTraceRecord stats;
+  stats.add("cache_lookups", manager.ReadCacheLookUps())
+      .add("cache_hits", manager.ReadCacheHits())
+      .add("live_nodes", manager.ReadNodeCount())
+      .add("peak_nodes", manager.ReadPeakNodeCount())
+      .add("gc_count", manager.ReadGarbageCollections())
+      .add("gc_time", manager.ReadGarbageCollectionTime() / 1000.0);
+  return stats;
+}
+} // namespace symbolic
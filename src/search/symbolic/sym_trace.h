@@ -0,0 +1,61 @@
+#ifndef SYMBOLIC_SYM_TRACE_H
+#define SYMBOLIC_SYM_TRACE_H
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class Cudd;
+
+namespace symbolic {
+
+/*
+ * JSON object that is built incrementally, e.g.,
+ * SymTraceRecord().add("g", 3).add("dir", "fw").str() == {"g":3,"dir":"fw"}
+ */
+class SymTraceRecord {
+  std::ostringstream json;
+  bool empty;
+
+  std::ostream &key(const std::string &name);
+
+public:
+  SymTraceRecord();
+
+  SymTraceRecord &add(const std::string &name, const std::string &value);
+  SymTraceRecord &add(const std::string &name, const char *value);
+  SymTraceRecord &add(const std::string &name, bool value);
+  SymTraceRecord &add(const std::string &name, int value);
+  SymTraceRecord &add(const std::string &name, long value);
+  SymTraceRecord &add(const std::string &name, double value);
+  SymTraceRecord &add(const std::string &name, const SymTraceRecord &object);
+  SymTraceRecord &add(const std::string &name,
+                      const std::vector<SymTraceRecord> &array);
+
+  std::string str() const;
+};
+
+/*
+ * Trace sink of the symbolic searches: one JSON record per line (JSON
+ * Lines). Records are buffered and written in blocks. The trace is only
+ * created if a trace file is given, so the searches do not compute any
+ * record otherwise.
+ */
+class SymTrace {
+  std::ofstream file;
+  std::string buffer;
+
+public:
+  explicit SymTrace(const std::string &filename);
+  ~SymTrace();
+
+  void write(const SymTraceRecord &record);
+  void flush();
+
+  // Cache, node and garbage collection counters of the CUDD manager
+  static SymTraceRecord cudd_stats(const Cudd &manager);
+};
+} // namespace symbolic
+
+#endif
@@ -5,6 +5,7 @@
 #include "sym_variables.h"
 #include "transition_relation.h"
 
+#include "../utils/system.h"
 #include "../utils/timer.h"
 #include <fstream>
 #include <iostream>
@@ -57,7 +58,8 @@ void mergeAux(std::vector<T> &elems, FunctionMerge f, int maxTime,
 
   // Merge Elements
   std::vector<T> aux;
-  while (elems.size() > 1 && (maxTime == 0 || merge_timer() * 1000 < maxTime)) {
+  while (elems.size() > 1 && (maxTime == 0 || merge_timer() * 1000 < maxTime) &&
+         !utils::is_cancellation_requested()) {
     if (elems.size() % 2 == 1) { // Ensure an even number
       int last = elems.size() - 1;
       try {
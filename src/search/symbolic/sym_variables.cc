@@ -5,6 +5,7 @@
 #include "../options/options.h"
 #include "../task_utils/task_properties.h"
 #include "../tasks/root_task.h"
+#include "../utils/system.h"
 #include "opt_order.h"
 #include "sym_axiom/sym_axiom_compilation.h"
 
@@ -23,14 +24,45 @@ void exceptionError(string /*message*/) {
   throw BDDError();
 }
 
+void SymVariables::set_handlers() {
+  manager->setHandler(exceptionError);
+  manager->setTimeoutHandler(exceptionError);
+  manager->setNodesExceededHandler(exceptionError);
+  // CUDD polls the callback when it allocates nodes, like the time limit
+  manager->setTerminationHandler(exceptionError);
+  Cudd_RegisterTerminationCallback(manager->getManager(), is_cancelled, this);
+}
+
+int SymVariables::is_cancelled(const void *vars) {
+  return static_cast<const SymVariables *>(vars)->interruptible &&
+         utils::is_cancellation_requested();
+}
+
 SymVariables::SymVariables(const Options &opts)
     : cudd_init_nodes(16000000L), cudd_init_cache_size(16000000L),
       cudd_init_available_memory(0L),
-      gamer_ordering(opts.get<bool>("gamer_ordering")) {}
+      gamer_ordering(opts.get<bool>("gamer_ordering")),
+      memory_timeline_type(MemoryTimeline(opts.get_enum("memory_timeline"))) {}
 
 SymVariables::SymVariables(bool gamer_ordering)
     : cudd_init_nodes(16000000L), cudd_init_cache_size(16000000L),
-      cudd_init_available_memory(0L), gamer_ordering(gamer_ordering) {}
+      cudd_init_available_memory(0L), gamer_ordering(gamer_ordering),
+      memory_timeline_type(MemoryTimeline::NONE) {}
+
+SymVariables::SymVariables(bool gamer_ordering, long cudd_init_nodes,
+                           long cudd_init_cache_size)
+    : cudd_init_nodes(cudd_init_nodes),
+      cudd_init_cache_size(cudd_init_cache_size),
+      cudd_init_available_memory(0L), gamer_ordering(gamer_ordering),
+      memory_timeline_type(MemoryTimeline::NONE) {}
+
+bool SymVariables::same_options(const SymVariables &other) const {
+  return cudd_init_nodes == other.cudd_init_nodes &&
+         cudd_init_cache_size == other.cudd_init_cache_size &&
+         cudd_init_available_memory == other.cudd_init_available_memory &&
+         gamer_ordering == other.gamer_ordering &&
+         memory_timeline_type == other.memory_timeline_type;
+}
 
 void SymVariables::init() {
   vector<int> var_order;
@@ -82,9 +114,11 @@ void SymVariables::init(const vector<int> &v_order) {
       new Cudd(_numBDDVars, 0, cudd_init_nodes / _numBDDVars,
                cudd_init_cache_size, cudd_init_available_memory));
 
-  manager->setHandler(exceptionError);
-  manager->setTimeoutHandler(exceptionError);
-  manager->setNodesExceededHandler(exceptionError);
+  set_handlers();
+  if (memory_timeline_type != MemoryTimeline::NONE) {
+    memory_timeline = unique_ptr<SymMemoryTimeline>(new SymMemoryTimeline(
+        *manager, memory_timeline_type == MemoryTimeline::STREAM));
+  }
 
   cout << "Generating binary variables" << endl;
   // Generate binary_variables
@@ -119,7 +153,7 @@ void SymVariables::init(const vector<int> &v_order) {
   cout << "Symbolic Variables... Done." << endl;
 
   ax_comp = std::shared_ptr<SymAxiomCompilation>(
-      new SymAxiomCompilation(std::shared_ptr<SymVariables>(this)));
+      new SymAxiomCompilation(this));
   if (task_properties::has_axioms(TaskProxy(*tasks::g_root_task))) {
     std::cout << "Creating Primary Representation for Derived Predicates..."
               << std::endl;
@@ -128,6 +162,53 @@ void SymVariables::init(const vector<int> &v_order) {
   }
 }
 
+static vector<BDD> transfer_bdds(const vector<BDD> &bdds, Cudd &manager) {
+  vector<BDD> res;
+  res.reserve(bdds.size());
+  for (const BDD &bdd : bdds) {
+    res.push_back(bdd.Transfer(manager));
+  }
+  return res;
+}
+
+unique_ptr<SymVariables> SymVariables::create_worker() const {
+  unique_ptr<SymVariables> worker(new SymVariables(gamer_ordering));
+  // Default sizes: workers only build small BDDs, e.g., single TRs
+  worker->manager = unique_ptr<Cudd>(new Cudd(variables.size(), 0));
+  worker->set_handlers();
+
+  worker->numBDDVars = numBDDVars;
+  worker->var_order = var_order;
+  worker->bdd_index_pre = bdd_index_pre;
+  worker->bdd_index_eff = bdd_index_eff;
+  worker->bdd_index_abs = bdd_index_abs;
+  for (size_t i = 0; i < variables.size(); i++) {
+    worker->variables.push_back(worker->manager->bddVar(i));
+  }
+  for (size_t var = 0; var < preconditionBDDs.size(); var++) {
+    worker->preconditionBDDs.push_back(
+        transfer_bdds(preconditionBDDs[var], *worker->manager));
+    worker->effectBDDs.push_back(
+        transfer_bdds(effectBDDs[var], *worker->manager));
+  }
+  worker->biimpBDDs = transfer_bdds(biimpBDDs, *worker->manager);
+  worker->validValues = transfer_bdds(validValues, *worker->manager);
+  worker->validBDD = validBDD.Transfer(*worker->manager);
+  worker->binState.resize(binState.size(), 0);
+
+  worker->ax_comp = make_shared<SymAxiomCompilation>(worker.get());
+  worker->ax_comp->copy_primary_representations(*ax_comp,
+                                                *worker->manager);
+  return worker;
+}
+
+vector<BDD> SymVariables::get_aux_vars(int n) {
+  while ((int)aux_variables.size() < n) {
+    aux_variables.push_back(manager->bddNewVarAtLevel(aux_variables.size()));
+  }
+  return vector<BDD>(aux_variables.begin(), aux_variables.begin() + n);
+}
+
 BDD SymVariables::getStateBDD(const std::vector<int> &state) const {
   BDD res = oneBDD();
   for (int i = var_order.size() - 1; i >= 0; i--) {
@@ -228,11 +309,16 @@ void SymVariables::print_options() const {
   cout << "CUDD Init: nodes=" << cudd_init_nodes
        << " cache=" << cudd_init_cache_size
        << " max_memory=" << cudd_init_available_memory
-       << " ordering: " << (gamer_ordering ? "gamer" : "fd") << endl;
+       << " ordering: " << (gamer_ordering ? "gamer" : "fd")
+       << " memory_timeline: " << memory_timeline_type << endl;
 }
 
 void SymVariables::add_options_to_parser(options::OptionParser &parser) {
   parser.add_option<bool>("gamer_ordering", "Use Gamer ordering optimization",
                           "true");
+  parser.add_enum_option("memory_timeline", MemoryTimelineValues,
+                         "record the garbage collections and reorderings of "
+                         "the CUDD manager and the memory in use",
+                         "NONE");
 }
 } // namespace symbolic
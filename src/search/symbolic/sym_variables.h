@@ -2,6 +2,8 @@
 #define SYMBOLIC_SYM_VARIABLES_H
 
 #include "sym_bucket.h"
+#include "sym_enums.h"
+#include "sym_memory_timeline.h"
 
 #include "../state_registry.h"
 #include "../tasks/root_task.h"
@@ -45,14 +47,21 @@ class SymVariables {
   const long cudd_init_cache_size;       // Initial cache size
   const long cudd_init_available_memory; // Maximum available memory (bytes)
   const bool gamer_ordering;
+  const MemoryTimeline memory_timeline_type;
 
   std::unique_ptr<Cudd> manager; // manager associated with this symbolic search
+  // Operations are only aborted on cancellation while a time limit is set,
+  // since only then the caller handles the BDDError
+  bool interruptible = false;
+  // Destroyed before the manager, as it removes its hooks from it
+  std::unique_ptr<SymMemoryTimeline> memory_timeline;
   std::shared_ptr<SymAxiomCompilation> ax_comp;  // used for axioms
   std::shared_ptr<StateRegistry> state_registry; // used for explicit stuff
 
   int numBDDVars; // Number of binary variables (just one set, the total number
   // is numBDDVars*3
   std::vector<BDD> variables; // BDD variables
+  std::vector<BDD> aux_variables; // Above all variables, e.g., to encode costs
 
   // The variable order must be complete.
   std::vector<int> var_order; // Variable(FD) order in the BDD
@@ -74,12 +83,26 @@ class SymVariables {
   std::vector<int> binState;
 
   void init(const std::vector<int> &v_order);
+  // All CUDD errors throw BDDError
+  void set_handlers();
+  static int is_cancelled(const void *vars);
 
 public:
   SymVariables(const options::Options &opts);
   SymVariables(bool gamer_ordering);
+  // Manager with the given initial number of nodes and cache size, e.g.,
+  // smaller ones if only few BDDs are needed
+  SymVariables(bool gamer_ordering, long cudd_init_nodes,
+               long cudd_init_cache_size);
   void init();
 
+  // True if both managers are created with the same options
+  bool same_options(const SymVariables &other) const;
+
+  // Copy of the variables in a new (small) CUDD manager. CUDD managers are
+  // not thread-safe, so each thread that builds BDDs needs its own copy.
+  std::unique_ptr<SymVariables> create_worker() const;
+
   std::shared_ptr<StateRegistry> get_state_registry() {
     if (state_registry == nullptr) {
       state_registry =
@@ -94,6 +117,11 @@ public:
 
   Cudd *get_manager() const { return manager.get(); }
 
+  // nullptr if the events of the manager are not recorded
+  SymMemoryTimeline *get_memory_timeline() const {
+    return memory_timeline.get();
+  }
+
   // State getStateFrom(const BDD & bdd) const;
   BDD getStateBDD(const std::vector<int> &state) const;
   BDD getStateBDD(const GlobalState &state) const;
@@ -178,12 +206,20 @@ public:
 
   inline BDD bddVar(int index) const { return variables[index]; }
 
+  // The first n auxiliary BDD variables, which precede all state variables
+  // in the order. They are created on first use and shared by all callers.
+  std::vector<BDD> get_aux_vars(int n);
+
   inline void setTimeLimit(int maxTime) {
     manager->SetTimeLimit(maxTime);
     manager->ResetStartTime();
+    interruptible = true;
   }
 
-  inline void unsetTimeLimit() { manager->UnsetTimeLimit(); }
+  inline void unsetTimeLimit() {
+    manager->UnsetTimeLimit();
+    interruptible = false;
+  }
 
   template <class T> int *getBinaryDescription(const T &state) {
     int pos = 0;
@@ -207,6 +243,8 @@ public:
     return &(binState[0]);
   }
 
+  const std::vector<int> &get_var_order() const { return var_order; }
+
   std::vector<std::string> get_fd_variable_names() const;
 
   static void add_options_to_parser(options::OptionParser &parser);
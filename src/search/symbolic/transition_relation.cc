@@ -19,6 +19,16 @@ TransitionRelation::TransitionRelation(SymVariables *sVars, OperatorID op_id,
   ops_ids.insert(op_id);
 }
 
+TransitionRelation::TransitionRelation(SymVariables *sVars, const BDD &tBDD_,
+                                       const vector<int> &effVars_, int cost_,
+                                       const set<OperatorID> &ops_ids_)
+    : sV(sVars), cost(cost_), tBDD(tBDD_), effVars(effVars_),
+      existsVars(sVars->oneBDD()), existsBwVars(sVars->oneBDD()),
+      ops_ids(ops_ids_) {
+  assert(is_sorted(effVars.begin(), effVars.end()));
+  init_swap_vars();
+}
+
 void TransitionRelation::init() {
   TaskProxy task_proxy(*tasks::g_root_task);
   OperatorProxy op = task_proxy.get_operators()[ops_ids.begin()->get_index()];
@@ -81,6 +91,10 @@ void TransitionRelation::init() {
   }
 
   sort(effVars.begin(), effVars.end());
+  init_swap_vars();
+}
+
+void TransitionRelation::init_swap_vars() {
   for (int var : effVars) {
     for (int bdd_var : sV->vars_index_pre(var)) {
       swapVarsS.push_back(sV->bddVar(bdd_var));
@@ -97,6 +111,20 @@ void TransitionRelation::init() {
   }
 }
 
+TransitionRelation TransitionRelation::transfer(SymVariables *target) const {
+  TransitionRelation res(*this);
+  Cudd &manager = *target->get_manager();
+  res.sV = target;
+  res.tBDD = tBDD.Transfer(manager);
+  res.existsVars = existsVars.Transfer(manager);
+  res.existsBwVars = existsBwVars.Transfer(manager);
+  for (size_t i = 0; i < swapVarsS.size(); ++i) {
+    res.swapVarsS[i] = swapVarsS[i].Transfer(manager);
+    res.swapVarsSp[i] = swapVarsSp[i].Transfer(manager);
+  }
+  return res;
+}
+
 BDD TransitionRelation::image(const BDD &from) const {
   BDD aux = from;
   BDD tmp = tBDD.AndAbstract(aux, existsVars);
@@ -125,6 +153,26 @@ BDD TransitionRelation::preimage(const BDD &from, int maxNodes) const {
   return res;
 }
 
+ADD TransitionRelation::image(const ADD &from) const {
+  std::vector<ADD> swapS, swapSp;
+  for (size_t i = 0; i < swapVarsS.size(); ++i) {
+    swapS.push_back(swapVarsS[i].Add());
+    swapSp.push_back(swapVarsSp[i].Add());
+  }
+  ADD tmp = (tBDD.Add() * from).ExistAbstract(existsVars.Add());
+  return tmp.SwapVariables(swapS, swapSp);
+}
+
+ADD TransitionRelation::preimage(const ADD &from) const {
+  std::vector<ADD> swapS, swapSp;
+  for (size_t i = 0; i < swapVarsS.size(); ++i) {
+    swapS.push_back(swapVarsS[i].Add());
+    swapSp.push_back(swapVarsSp[i].Add());
+  }
+  ADD tmp = from.SwapVariables(swapS, swapSp);
+  return (tBDD.Add() * tmp).ExistAbstract(existsBwVars.Add());
+}
+
 void TransitionRelation::merge(const TransitionRelation &t2, int maxNodes) {
   assert(cost == t2.cost);
   if (cost != t2.cost) {
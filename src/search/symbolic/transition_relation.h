@@ -32,11 +32,21 @@ class TransitionRelation {
 
   std::set<OperatorID> ops_ids; // List of operators represented by the TR
 
+  // Computes the swap variables and cubes from effVars
+  void init_swap_vars();
+
 public:
   // Constructor for transitions irrelevant for the abstraction
   TransitionRelation(SymVariables *sVars, OperatorID op_id, int cost_);
+  // TR given by its BDD, e.g., loaded from the TR cache
+  TransitionRelation(SymVariables *sVars, const BDD &tBDD_,
+                     const std::vector<int> &effVars_, int cost_,
+                     const std::set<OperatorID> &ops_ids_);
   void init();
 
+  // Copy of the TR in the manager of target
+  TransitionRelation transfer(SymVariables *target) const;
+
   // Copy constructor
   TransitionRelation(const TransitionRelation &) = default;
 
@@ -45,6 +55,11 @@ public:
   BDD image(const BDD &from, int maxNodes) const;
   BDD preimage(const BDD &from, int maxNodes) const;
 
+  // Image and preimage of ADDs, the values of all predecessors
+  // (successors) of a state are summed up
+  ADD image(const ADD &from) const;
+  ADD preimage(const ADD &from) const;
+
   void edeletion(const std::vector<std::vector<BDD>> &notMutexBDDsByFluentFw,
                  const std::vector<std::vector<BDD>> &notMutexBDDsByFluentBw,
                  const std::vector<std::vector<BDD>> &exactlyOneBDDsByFluent);
@@ -59,6 +74,8 @@ public:
 
   const std::set<OperatorID> &getOpsIds() const { return ops_ids; }
 
+  const std::vector<int> &getEffVars() const { return effVars; }
+
   const BDD &getBDD() const { return tBDD; }
 
   friend std::ostream &operator<<(std::ostream &os,
@@ -0,0 +1,719 @@
+#include "binary_root_task.h"
+
+#include "root_task.h"
+
+#include "../mutex_group.h"
+
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using utils::ExitCode;
+
+namespace tasks {
+static const char BINARY_MAGIC[8] = "SASBIN";
+static const int32_t BINARY_VERSION = 1;
+
+/*
+  Sections of an operator block. The operators and the axioms are stored
+  in one block each. Effect conditions are indexed by the position of the
+  effect in EFFS.
+*/
+enum OperatorSection {
+  OP_DATA,      // cost, name id
+  PRE_OFFSETS,  // num_ops + 1
+  PRES,         // var, value
+  EFF_OFFSETS,  // num_ops + 1
+  EFFS,         // var, value
+  COND_OFFSETS, // num_effects + 1
+  CONDS,        // var, value
+  NUM_OPERATOR_SECTIONS
+};
+
+enum Section {
+  VARIABLES,      // domain size, axiom layer, default value, name id
+  FACT_OFFSETS,   // num_vars + 1
+  FACT_NAMES,     // name id
+  MUTEX_OFFSETS,  // num_facts + 1
+  MUTEX_FACTS,    // var, value (sorted for each fact)
+  GROUP_OFFSETS,  // num_groups + 1
+  GROUP_FACTS,    // var, value
+  GROUP_FLAGS,    // 1: exactly one, 2: detected fw
+  INITIAL_STATE,  // value
+  GOALS,          // var, value
+  UTILITIES,      // var, value, utility
+  PLAN_BOUND,     // bound
+  STRING_OFFSETS, // num_strings + 1
+  STRING_CHARS,   // characters (not null-terminated)
+  OPERATORS,
+  AXIOMS = OPERATORS + NUM_OPERATOR_SECTIONS,
+  NUM_SECTIONS = AXIOMS + NUM_OPERATOR_SECTIONS
+};
+
+struct BinaryHeader {
+  char magic[8];
+  int32_t version;
+  int32_t num_sections;
+  // Followed by the offsets and sizes (in bytes) of all sections
+};
+
+static const size_t ALIGNMENT = 8;
+
+static size_t align(size_t offset) {
+  return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+static size_t get_table_size() {
+  return sizeof(BinaryHeader) + 2 * NUM_SECTIONS * sizeof(uint64_t);
+}
+
+static void input_error(const string &filename, const string &msg) {
+  cerr << "Invalid binary task " << filename << ": " << msg << endl;
+  utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+}
+
+class BinaryTaskWriter {
+  vector<vector<int32_t>> sections;
+  string chars;
+
+  int add_string(const string &str) {
+    vector<int32_t> &offsets = sections[STRING_OFFSETS];
+    chars += str;
+    offsets.push_back(chars.size());
+    return offsets.size() - 2;
+  }
+
+  void add_fact(int section, const FactPair &fact) {
+    sections[section].push_back(fact.var);
+    sections[section].push_back(fact.value);
+  }
+
+  void add_variables(const AbstractTask &task);
+  void add_mutexes(const AbstractTask &task);
+  void add_operators(const AbstractTask &task, bool is_axiom);
+
+public:
+  explicit BinaryTaskWriter(const AbstractTask &task);
+
+  void write(const string &filename) const;
+};
+
+BinaryTaskWriter::BinaryTaskWriter(const AbstractTask &task)
+    : sections(NUM_SECTIONS) {
+  sections[STRING_OFFSETS].push_back(0);
+  add_variables(task);
+  add_mutexes(task);
+
+  for (int value : task.get_initial_state_values()) {
+    sections[INITIAL_STATE].push_back(value);
+  }
+  for (int i = 0; i < task.get_num_goals(); ++i) {
+    add_fact(GOALS, task.get_goal_fact(i));
+  }
+  for (const auto &utility : task.get_utilities()) {
+    add_fact(UTILITIES, utility.first);
+    sections[UTILITIES].push_back(utility.second);
+  }
+  sections[PLAN_BOUND].push_back(task.get_plan_bound());
+
+  add_operators(task, false);
+  add_operators(task, true);
+}
+
+void BinaryTaskWriter::add_variables(const AbstractTask &task) {
+  sections[FACT_OFFSETS].push_back(0);
+  for (int var = 0; var < task.get_num_variables(); ++var) {
+    int domain_size = task.get_variable_domain_size(var);
+    sections[VARIABLES].push_back(domain_size);
+    sections[VARIABLES].push_back(task.get_variable_axiom_layer(var));
+    sections[VARIABLES].push_back(task.get_variable_default_axiom_value(var));
+    sections[VARIABLES].push_back(add_string(task.get_variable_name(var)));
+    for (int value = 0; value < domain_size; ++value) {
+      sections[FACT_NAMES].push_back(
+          add_string(task.get_fact_name(FactPair(var, value))));
+    }
+    sections[FACT_OFFSETS].push_back(sections[FACT_NAMES].size());
+  }
+}
+
+void BinaryTaskWriter::add_mutexes(const AbstractTask &task) {
+  const vector<int32_t> &fact_offsets = sections[FACT_OFFSETS];
+  vector<MutexGroup> mutex_groups = task.get_mutex_groups();
+
+  // Same mutexes as in the root task: facts of different variables
+  vector<set<FactPair>> mutexes(fact_offsets.back());
+  sections[GROUP_OFFSETS].push_back(0);
+  for (const MutexGroup &group : mutex_groups) {
+    for (const FactPair &fact1 : group.getFacts()) {
+      add_fact(GROUP_FACTS, fact1);
+      for (const FactPair &fact2 : group.getFacts()) {
+        if (fact1.var != fact2.var) {
+          mutexes[fact_offsets[fact1.var] + fact1.value].insert(fact2);
+        }
+      }
+    }
+    sections[GROUP_OFFSETS].push_back(sections[GROUP_FACTS].size() / 2);
+    sections[GROUP_FLAGS].push_back((group.isExactlyOne() ? 1 : 0) |
+                                    (group.detectedFW() ? 2 : 0));
+  }
+
+  sections[MUTEX_OFFSETS].push_back(0);
+  for (const set<FactPair> &fact_mutexes : mutexes) {
+    for (const FactPair &fact : fact_mutexes) {
+      add_fact(MUTEX_FACTS, fact);
+    }
+    sections[MUTEX_OFFSETS].push_back(sections[MUTEX_FACTS].size() / 2);
+  }
+}
+
+void BinaryTaskWriter::add_operators(const AbstractTask &task, bool is_axiom) {
+  int base = is_axiom ? AXIOMS : OPERATORS;
+  int num_ops = is_axiom ? task.get_num_axioms() : task.get_num_operators();
+  sections[base + PRE_OFFSETS].push_back(0);
+  sections[base + EFF_OFFSETS].push_back(0);
+  sections[base + COND_OFFSETS].push_back(0);
+  for (int op = 0; op < num_ops; ++op) {
+    sections[base + OP_DATA].push_back(task.get_operator_cost(op, is_axiom));
+    sections[base + OP_DATA].push_back(
+        add_string(task.get_operator_name(op, is_axiom)));
+    int num_pres = task.get_num_operator_preconditions(op, is_axiom);
+    for (int i = 0; i < num_pres; ++i) {
+      add_fact(base + PRES, task.get_operator_precondition(op, i, is_axiom));
+    }
+    sections[base + PRE_OFFSETS].push_back(sections[base + PRES].size() / 2);
+    int num_effs = task.get_num_operator_effects(op, is_axiom);
+    for (int eff = 0; eff < num_effs; ++eff) {
+      add_fact(base + EFFS, task.get_operator_effect(op, eff, is_axiom));
+      int num_conds =
+          task.get_num_operator_effect_conditions(op, eff, is_axiom);
+      for (int i = 0; i < num_conds; ++i) {
+        add_fact(base + CONDS,
+                 task.get_operator_effect_condition(op, eff, i, is_axiom));
+      }
+      sections[base + COND_OFFSETS].push_back(sections[base + CONDS].size() /
+                                              2);
+    }
+    sections[base + EFF_OFFSETS].push_back(sections[base + EFFS].size() / 2);
+  }
+}
+
+void BinaryTaskWriter::write(const string &filename) const {
+  vector<uint64_t> offsets(NUM_SECTIONS), sizes(NUM_SECTIONS);
+  size_t offset = align(get_table_size());
+  for (int i = 0; i < NUM_SECTIONS; ++i) {
+    offsets[i] = offset;
+    sizes[i] = i == STRING_CHARS ? chars.size()
+                                 : sections[i].size() * sizeof(int32_t);
+    offset = align(offset + sizes[i]);
+  }
+
+  ofstream out(filename, ios::binary);
+  BinaryHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+  header.version = BINARY_VERSION;
+  header.num_sections = NUM_SECTIONS;
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(offsets.data()),
+            NUM_SECTIONS * sizeof(uint64_t));
+  out.write(reinterpret_cast<const char *>(sizes.data()),
+            NUM_SECTIONS * sizeof(uint64_t));
+  const char padding[ALIGNMENT] = {};
+  size_t written = get_table_size();
+  for (int i = 0; i < NUM_SECTIONS; ++i) {
+    out.write(padding, offsets[i] - written);
+    if (i == STRING_CHARS) {
+      out.write(chars.data(), sizes[i]);
+    } else {
+      out.write(reinterpret_cast<const char *>(sections[i].data()), sizes[i]);
+    }
+    written = offsets[i] + sizes[i];
+  }
+  if (!out) {
+    cerr << "Error: could not write binary task " << filename << endl;
+    utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+  }
+}
+
+void write_binary_task(const AbstractTask &task, const string &filename) {
+  BinaryTaskWriter(task).write(filename);
+}
+
+// Array of a section in the mapped file
+struct IntArray {
+  const int32_t *data = nullptr;
+  size_t size = 0;
+
+  int operator[](size_t i) const {
+    assert(i < size);
+    return data[i];
+  }
+
+  FactPair fact(size_t i) const {
+    assert(2 * i + 1 < size);
+    return FactPair(data[2 * i], data[2 * i + 1]);
+  }
+};
+
+class BinaryRootTask : public AbstractTask {
+  string filename;
+  const char *file_data;
+  size_t file_size;
+  // Fallback if the file cannot be mapped into memory
+  vector<char> buffer;
+
+  vector<IntArray> sections;
+  const char *chars;
+  size_t num_chars;
+  int num_variables;
+
+  void map_file();
+  void read_sections();
+  const IntArray &get_section(int section, bool is_axiom) const;
+  void check_offsets(int offsets, size_t num_entries, int data,
+                     int entry_size) const;
+  void check_contents() const;
+  bool is_valid_fact(int var, int value) const;
+  void check_facts(int section, int entry_size) const;
+  void check_strings(int section, int entry_size, int pos) const;
+  string get_string(int id) const;
+  int get_op_array_index(int section, int index, int pos,
+                         bool is_axiom) const;
+  int get_effect_index(int op_index, int eff_index, bool is_axiom) const;
+
+public:
+  explicit BinaryRootTask(const string &filename);
+  virtual ~BinaryRootTask() override;
+
+  virtual int get_num_variables() const override;
+  virtual string get_variable_name(int var) const override;
+  virtual int get_variable_domain_size(int var) const override;
+  virtual int get_variable_axiom_layer(int var) const override;
+  virtual int get_variable_default_axiom_value(int var) const override;
+  virtual string get_fact_name(const FactPair &fact) const override;
+  virtual bool are_facts_mutex(const FactPair &fact1,
+                               const FactPair &fact2) const override;
+
+  virtual int get_operator_cost(int index, bool is_axiom) const override;
+  virtual string get_operator_name(int index, bool is_axiom) const override;
+  virtual int get_num_operators() const override;
+  virtual int get_num_operator_preconditions(int index,
+                                             bool is_axiom) const override;
+  virtual FactPair get_operator_precondition(int op_index, int fact_index,
+                                             bool is_axiom) const override;
+  virtual int get_num_operator_effects(int op_index,
+                                       bool is_axiom) const override;
+  virtual int get_num_operator_effect_conditions(int op_index, int eff_index,
+                                                 bool is_axiom) const override;
+  virtual FactPair get_operator_effect_condition(int op_index, int eff_index,
+                                                 int cond_index,
+                                                 bool is_axiom) const override;
+  virtual FactPair get_operator_effect(int op_index, int eff_index,
+                                       bool is_axiom) const override;
+  virtual int
+  convert_operator_index(int index,
+                         const AbstractTask *ancestor_task) const override;
+
+  virtual int get_num_axioms() const override;
+
+  virtual int get_num_goals() const override;
+  virtual FactPair get_goal_fact(int index) const override;
+
+  virtual vector<int> get_initial_state_values() const override;
+  std::vector<MutexGroup> get_mutex_groups() const override;
+
+  virtual map<FactPair, int> get_utilities() const override;
+  virtual int get_plan_bound() const override;
+
+  virtual void
+  convert_state_values(vector<int> &values,
+                       const AbstractTask *ancestor_task) const override;
+};
+
+BinaryRootTask::BinaryRootTask(const string &filename)
+    : filename(filename), file_data(nullptr), file_size(0),
+      sections(NUM_SECTIONS), chars(nullptr), num_chars(0),
+      num_variables(0) {
+  map_file();
+  read_sections();
+}
+
+BinaryRootTask::~BinaryRootTask() {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+  if (buffer.empty() && file_data) {
+    munmap(const_cast<char *>(file_data), file_size);
+  }
+#endif
+}
+
+void BinaryRootTask::map_file() {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    input_error(filename, "could not open file");
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+    file_size = file_stat.st_size;
+    void *data = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      file_data = static_cast<const char *>(data);
+    }
+  }
+  close(fd);
+  if (file_data) {
+    return;
+  }
+#endif
+  ifstream in(filename, ios::binary);
+  if (!in) {
+    input_error(filename, "could not open file");
+  }
+  buffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  file_data = buffer.data();
+  file_size = buffer.size();
+}
+
+void BinaryRootTask::read_sections() {
+  if (file_size < get_table_size()) {
+    input_error(filename, "file too small");
+  }
+  BinaryHeader header;
+  memcpy(&header, file_data, sizeof(header));
+  if (memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) {
+    input_error(filename, "wrong magic number");
+  }
+  if (header.version != BINARY_VERSION) {
+    input_error(filename, "expected version " + to_string(BINARY_VERSION) +
+                              ", got " + to_string(header.version));
+  }
+  if (header.num_sections != NUM_SECTIONS) {
+    input_error(filename, "wrong number of sections");
+  }
+  vector<uint64_t> offsets(NUM_SECTIONS), sizes(NUM_SECTIONS);
+  memcpy(offsets.data(), file_data + sizeof(header),
+         NUM_SECTIONS * sizeof(uint64_t));
+  memcpy(sizes.data(),
+         file_data + sizeof(header) + NUM_SECTIONS * sizeof(uint64_t),
+         NUM_SECTIONS * sizeof(uint64_t));
+  for (int i = 0; i < NUM_SECTIONS; ++i) {
+    if (offsets[i] % ALIGNMENT != 0 || offsets[i] > file_size ||
+        sizes[i] > file_size - offsets[i] ||
+        (i != STRING_CHARS && sizes[i] % sizeof(int32_t) != 0)) {
+      input_error(filename, "invalid section " + to_string(i));
+    }
+    sections[i].data =
+        reinterpret_cast<const int32_t *>(file_data + offsets[i]);
+    sections[i].size = sizes[i] / sizeof(int32_t);
+  }
+  chars = file_data + offsets[STRING_CHARS];
+  num_chars = sizes[STRING_CHARS];
+
+  if (sections[VARIABLES].size % 4 != 0 || sections[PLAN_BOUND].size != 1 ||
+      sections[GOALS].size % 2 != 0 || sections[UTILITIES].size % 3 != 0 ||
+      sections[OPERATORS + OP_DATA].size % 2 != 0 ||
+      sections[AXIOMS + OP_DATA].size % 2 != 0 ||
+      sections[STRING_OFFSETS].size == 0) {
+    input_error(filename, "invalid section sizes");
+  }
+  num_variables = sections[VARIABLES].size / 4;
+  if ((int)sections[INITIAL_STATE].size != num_variables) {
+    input_error(filename, "invalid initial state");
+  }
+  check_offsets(FACT_OFFSETS, num_variables, FACT_NAMES, 1);
+  check_offsets(MUTEX_OFFSETS, sections[FACT_NAMES].size, MUTEX_FACTS, 2);
+  check_offsets(GROUP_OFFSETS, sections[GROUP_FLAGS].size, GROUP_FACTS, 2);
+  check_offsets(STRING_OFFSETS, sections[STRING_OFFSETS].size - 1,
+                STRING_CHARS, 1);
+  for (int base : {OPERATORS, AXIOMS}) {
+    size_t num_ops = sections[base + OP_DATA].size / 2;
+    check_offsets(base + PRE_OFFSETS, num_ops, base + PRES, 2);
+    check_offsets(base + EFF_OFFSETS, num_ops, base + EFFS, 2);
+    check_offsets(base + COND_OFFSETS, sections[base + EFFS].size / 2,
+                  base + CONDS, 2);
+  }
+  check_contents();
+}
+
+/*
+  Checks that all string ids and facts refer to existing strings and
+  variable values, so that the accessors cannot read out of bounds. The
+  operator and axiom indices are implied by the (checked) offsets.
+*/
+void BinaryRootTask::check_contents() const {
+  const IntArray &fact_offsets = sections[FACT_OFFSETS];
+  for (int var = 0; var < num_variables; ++var) {
+    int domain_size = get_variable_domain_size(var);
+    if (domain_size < 1 ||
+        fact_offsets[var + 1] - fact_offsets[var] != domain_size ||
+        !is_valid_fact(var, get_variable_default_axiom_value(var)) ||
+        !is_valid_fact(var, sections[INITIAL_STATE][var])) {
+      input_error(filename, "invalid variable " + to_string(var));
+    }
+  }
+  check_strings(VARIABLES, 4, 3);
+  check_strings(FACT_NAMES, 1, 0);
+  check_facts(MUTEX_FACTS, 2);
+  check_facts(GROUP_FACTS, 2);
+  check_facts(GOALS, 2);
+  check_facts(UTILITIES, 3);
+  for (int base : {OPERATORS, AXIOMS}) {
+    check_strings(base + OP_DATA, 2, 1);
+    check_facts(base + PRES, 2);
+    check_facts(base + EFFS, 2);
+    check_facts(base + CONDS, 2);
+  }
+}
+
+bool BinaryRootTask::is_valid_fact(int var, int value) const {
+  return var >= 0 && var < num_variables && value >= 0 &&
+         value < get_variable_domain_size(var);
+}
+
+// Checks the facts stored at the beginning of each entry of the section
+void BinaryRootTask::check_facts(int section, int entry_size) const {
+  const IntArray &array = sections[section];
+  for (size_t i = 0; i < array.size; i += entry_size) {
+    if (!is_valid_fact(array[i], array[i + 1])) {
+      input_error(filename, "invalid fact in section " + to_string(section));
+    }
+  }
+}
+
+// Checks the string ids stored at position pos of each entry of the section
+void BinaryRootTask::check_strings(int section, int entry_size,
+                                   int pos) const {
+  const IntArray &array = sections[section];
+  int num_strings = sections[STRING_OFFSETS].size - 1;
+  for (size_t i = pos; i < array.size; i += entry_size) {
+    if (array[i] < 0 || array[i] >= num_strings) {
+      input_error(filename,
+                  "invalid string id in section " + to_string(section));
+    }
+  }
+}
+
+/*
+  Checks that offsets has num_entries + 1 non-decreasing entries that
+  cover the section data with entries of the given size (in integers).
+*/
+void BinaryRootTask::check_offsets(int offsets, size_t num_entries, int data,
+                                   int entry_size) const {
+  const IntArray &array = sections[offsets];
+  size_t data_size =
+      data == STRING_CHARS ? num_chars : sections[data].size;
+  bool valid = array.size == num_entries + 1 && array[0] == 0 &&
+               (size_t)array[num_entries] * entry_size == data_size;
+  for (size_t i = 0; valid && i < num_entries; ++i) {
+    valid = array[i] <= array[i + 1];
+  }
+  if (!valid) {
+    input_error(filename, "invalid section " + to_string(offsets));
+  }
+}
+
+const IntArray &BinaryRootTask::get_section(int section, bool is_axiom) const {
+  return sections[(is_axiom ? AXIOMS : OPERATORS) + section];
+}
+
+string BinaryRootTask::get_string(int id) const {
+  const IntArray &offsets = sections[STRING_OFFSETS];
+  return string(chars + offsets[id], offsets[id + 1] - offsets[id]);
+}
+
+/*
+  Position of the pos-th entry of index in the given section. The offsets
+  of each operator section are stored in the section before it.
+*/
+int BinaryRootTask::get_op_array_index(int section, int index, int pos,
+                                       bool is_axiom) const {
+  assert(pos >= 0);
+  assert(get_section(section - 1, is_axiom)[index] + pos <
+         get_section(section - 1, is_axiom)[index + 1]);
+  return get_section(section - 1, is_axiom)[index] + pos;
+}
+
+int BinaryRootTask::get_effect_index(int op_index, int eff_index,
+                                     bool is_axiom) const {
+  return get_op_array_index(EFFS, op_index, eff_index, is_axiom);
+}
+
+int BinaryRootTask::get_num_variables() const { return num_variables; }
+
+string BinaryRootTask::get_variable_name(int var) const {
+  return get_string(sections[VARIABLES][4 * var + 3]);
+}
+
+int BinaryRootTask::get_variable_domain_size(int var) const {
+  return sections[VARIABLES][4 * var];
+}
+
+int BinaryRootTask::get_variable_axiom_layer(int var) const {
+  return sections[VARIABLES][4 * var + 1];
+}
+
+int BinaryRootTask::get_variable_default_axiom_value(int var) const {
+  return sections[VARIABLES][4 * var + 2];
+}
+
+string BinaryRootTask::get_fact_name(const FactPair &fact) const {
+  assert(fact.value < get_variable_domain_size(fact.var));
+  int fact_id = sections[FACT_OFFSETS][fact.var] + fact.value;
+  return get_string(sections[FACT_NAMES][fact_id]);
+}
+
+bool BinaryRootTask::are_facts_mutex(const FactPair &fact1,
+                                     const FactPair &fact2) const {
+  if (fact1.var == fact2.var) {
+    // Same variable: mutex iff different value.
+    return fact1.value != fact2.value;
+  }
+  int fact_id = sections[FACT_OFFSETS][fact1.var] + fact1.value;
+  const IntArray &mutexes = sections[MUTEX_FACTS];
+  // Binary search in the sorted mutexes of fact1
+  int low = sections[MUTEX_OFFSETS][fact_id];
+  int high = sections[MUTEX_OFFSETS][fact_id + 1];
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    FactPair fact = mutexes.fact(mid);
+    if (fact == fact2) {
+      return true;
+    } else if (fact < fact2) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return false;
+}
+
+int BinaryRootTask::get_operator_cost(int index, bool is_axiom) const {
+  return get_section(OP_DATA, is_axiom)[2 * index];
+}
+
+string BinaryRootTask::get_operator_name(int index, bool is_axiom) const {
+  return get_string(get_section(OP_DATA, is_axiom)[2 * index + 1]);
+}
+
+int BinaryRootTask::get_num_operators() const {
+  return sections[OPERATORS + OP_DATA].size / 2;
+}
+
+int BinaryRootTask::get_num_operator_preconditions(int index,
+                                                   bool is_axiom) const {
+  const IntArray &offsets = get_section(PRE_OFFSETS, is_axiom);
+  return offsets[index + 1] - offsets[index];
+}
+
+FactPair BinaryRootTask::get_operator_precondition(int op_index,
+                                                   int fact_index,
+                                                   bool is_axiom) const {
+  return get_section(PRES, is_axiom)
+      .fact(get_op_array_index(PRES, op_index, fact_index, is_axiom));
+}
+
+int BinaryRootTask::get_num_operator_effects(int op_index,
+                                             bool is_axiom) const {
+  const IntArray &offsets = get_section(EFF_OFFSETS, is_axiom);
+  return offsets[op_index + 1] - offsets[op_index];
+}
+
+int BinaryRootTask::get_num_operator_effect_conditions(int op_index,
+                                                       int eff_index,
+                                                       bool is_axiom) const {
+  int effect = get_effect_index(op_index, eff_index, is_axiom);
+  const IntArray &offsets = get_section(COND_OFFSETS, is_axiom);
+  return offsets[effect + 1] - offsets[effect];
+}
+
+FactPair BinaryRootTask::get_operator_effect_condition(int op_index,
+                                                       int eff_index,
+                                                       int cond_index,
+                                                       bool is_axiom) const {
+  int effect = get_effect_index(op_index, eff_index, is_axiom);
+  return get_section(CONDS, is_axiom)
+      .fact(get_op_array_index(CONDS, effect, cond_index, is_axiom));
+}
+
+FactPair BinaryRootTask::get_operator_effect(int op_index, int eff_index,
+                                             bool is_axiom) const {
+  return get_section(EFFS, is_axiom)
+      .fact(get_effect_index(op_index, eff_index, is_axiom));
+}
+
+int BinaryRootTask::convert_operator_index(
+    int index, const AbstractTask *ancestor_task) const {
+  if (this != ancestor_task) {
+    ABORT("Invalid operator ID conversion");
+  }
+  return index;
+}
+
+int BinaryRootTask::get_num_axioms() const {
+  return sections[AXIOMS + OP_DATA].size / 2;
+}
+
+int BinaryRootTask::get_num_goals() const { return sections[GOALS].size / 2; }
+
+FactPair BinaryRootTask::get_goal_fact(int index) const {
+  return sections[GOALS].fact(index);
+}
+
+vector<int> BinaryRootTask::get_initial_state_values() const {
+  const IntArray &state = sections[INITIAL_STATE];
+  return vector<int>(state.data, state.data + state.size);
+}
+
+std::vector<MutexGroup> BinaryRootTask::get_mutex_groups() const {
+  const IntArray &offsets = sections[GROUP_OFFSETS];
+  const IntArray &flags = sections[GROUP_FLAGS];
+  vector<MutexGroup> mutex_groups;
+  mutex_groups.reserve(flags.size);
+  for (size_t group = 0; group < flags.size; ++group) {
+    vector<FactPair> facts;
+    for (int i = offsets[group]; i < offsets[group + 1]; ++i) {
+      facts.push_back(sections[GROUP_FACTS].fact(i));
+    }
+    mutex_groups.emplace_back(move(facts), flags[group] & 1, flags[group] & 2);
+  }
+  return mutex_groups;
+}
+
+map<FactPair, int> BinaryRootTask::get_utilities() const {
+  const IntArray &utilities = sections[UTILITIES];
+  map<FactPair, int> result;
+  for (size_t i = 0; i < utilities.size; i += 3) {
+    result[FactPair(utilities[i], utilities[i + 1])] = utilities[i + 2];
+  }
+  return result;
+}
+
+int BinaryRootTask::get_plan_bound() const { return sections[PLAN_BOUND][0]; }
+
+void BinaryRootTask::convert_state_values(
+    vector<int> &, const AbstractTask *ancestor_task) const {
+  if (this != ancestor_task) {
+    ABORT("Invalid state conversion");
+  }
+}
+
+void read_binary_root_task(const string &filename) {
+  assert(!g_root_task);
+  g_root_task = make_shared<BinaryRootTask>(filename);
+}
+} // namespace tasks
@@ -0,0 +1,24 @@
+#ifndef TASKS_BINARY_ROOT_TASK_H
+#define TASKS_BINARY_ROOT_TASK_H
+
+#include "../abstract_task.h"
+
+#include <string>
+
+/*
+  Binary representation of the root task. All data is stored in flat
+  arrays of 32-bit integers (one section per array) that are used in place
+  from a memory-mapped file, so that loading a task does not parse or copy
+  it. Names are stored in a shared string table. The mutexes of each fact
+  are precomputed as a sorted list, and the initial state is stored after
+  evaluating the axioms.
+*/
+namespace tasks {
+// Writes the task in binary format; exits with an error if this fails.
+extern void write_binary_task(const AbstractTask &task,
+                              const std::string &filename);
+
+// Maps the binary task stored in filename and sets it as root task.
+extern void read_binary_root_task(const std::string &filename);
+} // namespace tasks
+#endif
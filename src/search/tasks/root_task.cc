@@ -22,6 +22,7 @@ using utils::ExitCode;
 namespace tasks {
 static const int PRE_FILE_VERSION = 3;
 shared_ptr<AbstractTask> g_root_task = nullptr;
+bool g_root_task_reused = false;
 
 struct ExplicitVariable {
   int domain_size;
@@ -5,6 +5,9 @@
 
 namespace tasks {
 extern std::shared_ptr<AbstractTask> g_root_task;
+// True in the planner service (see planner.cc), where several searches solve
+// the same root task one after another and may share what they derive from it
+extern bool g_root_task_reused;
 extern void read_root_task(std::istream &in);
 } // namespace tasks
 #endif
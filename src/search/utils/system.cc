@@ -9,6 +9,8 @@ const char *get_exit_code_message_reentrant(ExitCode exitcode) {
     switch (exitcode) {
     case ExitCode::SUCCESS:
         return "Solutions found.";
+    case ExitCode::SEARCH_PLAN_FOUND_AND_OUT_OF_TIME:
+        return "Search cancelled after finding solutions.";
     case ExitCode::SEARCH_CRITICAL_ERROR:
         return "Unexplained error occurred.";
     case ExitCode::SEARCH_INPUT_ERROR:
@@ -31,6 +33,7 @@ const char *get_exit_code_message_reentrant(ExitCode exitcode) {
 bool is_exit_code_error_reentrant(ExitCode exitcode) {
     switch (exitcode) {
     case ExitCode::SUCCESS:
+    case ExitCode::SEARCH_PLAN_FOUND_AND_OUT_OF_TIME:
     case ExitCode::SEARCH_UNSOLVABLE:
     case ExitCode::SEARCH_UNSOLVED_INCOMPLETE:
     case ExitCode::SEARCH_OUT_OF_MEMORY:
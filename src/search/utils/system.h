@@ -38,6 +38,8 @@ enum class ExitCode {
     */
     // 0-9: exit codes denoting a plan was found
     SUCCESS = 0,
+    // The search was cancelled by a signal after finding some plans
+    SEARCH_PLAN_FOUND_AND_OUT_OF_TIME = 2,
 
     // 10-19: exit codes denoting no plan was found (without any error)
     SEARCH_UNSOLVABLE = 11,  // Task is provably unsolvable with given bound.
@@ -60,6 +62,15 @@ int get_peak_memory_in_kb();
 const char *get_exit_code_message_reentrant(ExitCode exitcode);
 bool is_exit_code_error_reentrant(ExitCode exitcode);
 void register_event_handlers();
+/*
+  Replaces the handlers of SIGTERM, SIGINT and SIGXCPU by one that only
+  requests the cancellation of the search, which the search engine has to
+  poll. A second SIGTERM or SIGINT terminates the process as usual. After a
+  SIGXCPU, the process is killed when it reaches the hard CPU limit, which is
+  usually one second later.
+*/
+void register_cancellation_handlers();
+bool is_cancellation_requested();
 void report_exit_code_reentrant(ExitCode exitcode);
 int get_process_id();
 }
@@ -177,6 +177,39 @@ void signal_handler(int signal_number) {
     raise(signal_number);
 }
 
+static volatile sig_atomic_t cancellation_requested = 0;
+
+static void set_signal_handler(int signal_number, void (*handler)(int),
+                               int flags) {
+    struct sigaction signal_action;
+    signal_action.sa_handler = handler;
+    // Block all signals we handle while one of them is handled.
+    sigemptyset(&signal_action.sa_mask);
+    sigaddset(&signal_action.sa_mask, SIGABRT);
+    sigaddset(&signal_action.sa_mask, SIGTERM);
+    sigaddset(&signal_action.sa_mask, SIGSEGV);
+    sigaddset(&signal_action.sa_mask, SIGINT);
+    sigaddset(&signal_action.sa_mask, SIGXCPU);
+    signal_action.sa_flags = flags;
+    sigaction(signal_number, &signal_action, 0);
+}
+
+void cancellation_handler(int signal_number) {
+    write_reentrant_str(STDOUT_FILENO, "caught signal ");
+    write_reentrant_int(STDOUT_FILENO, signal_number);
+    write_reentrant_str(STDOUT_FILENO, " -- cancelling search\n");
+    cancellation_requested = 1;
+    /*
+      A second SIGTERM or SIGINT exits at once. Further SIGXCPUs are ignored,
+      but the driver sets the hard CPU limit one second above the soft one
+      (see driver/limits.py), after which the kernel sends SIGKILL. So the
+      search only has about one second to write a plan after a SIGXCPU.
+    */
+    if (signal_number != SIGXCPU) {
+        set_signal_handler(signal_number, signal_handler, SA_RESETHAND);
+    }
+}
+
 /*
   NOTE: we have two variants of obtaining peak memory information.
         get_peak_memory_in_kb() is used during the regular execution.
@@ -230,23 +263,22 @@ void register_event_handlers() {
 #elif OPERATING_SYSTEM == OSX
     atexit(exit_handler);
 #endif
-    struct sigaction default_signal_action;
-    default_signal_action.sa_handler = signal_handler;
-    // Block all signals we handle while one of them is handled.
-    sigemptyset(&default_signal_action.sa_mask);
-    sigaddset(&default_signal_action.sa_mask, SIGABRT);
-    sigaddset(&default_signal_action.sa_mask, SIGTERM);
-    sigaddset(&default_signal_action.sa_mask, SIGSEGV);
-    sigaddset(&default_signal_action.sa_mask, SIGINT);
-    sigaddset(&default_signal_action.sa_mask, SIGXCPU);
     // Reset handler to default action after completion.
-    default_signal_action.sa_flags = SA_RESETHAND;
+    set_signal_handler(SIGABRT, signal_handler, SA_RESETHAND);
+    set_signal_handler(SIGTERM, signal_handler, SA_RESETHAND);
+    set_signal_handler(SIGSEGV, signal_handler, SA_RESETHAND);
+    set_signal_handler(SIGINT, signal_handler, SA_RESETHAND);
+    set_signal_handler(SIGXCPU, signal_handler, SA_RESETHAND);
+}
+
+void register_cancellation_handlers() {
+    set_signal_handler(SIGTERM, cancellation_handler, 0);
+    set_signal_handler(SIGINT, cancellation_handler, 0);
+    set_signal_handler(SIGXCPU, cancellation_handler, 0);
+}
 
-    sigaction(SIGABRT, &default_signal_action, 0);
-    sigaction(SIGTERM, &default_signal_action, 0);
-    sigaction(SIGSEGV, &default_signal_action, 0);
-    sigaction(SIGINT, &default_signal_action, 0);
-    sigaction(SIGXCPU, &default_signal_action, 0);
+bool is_cancellation_requested() {
+    return cancellation_requested;
 }
 
 void report_exit_code_reentrant(ExitCode exitcode) {
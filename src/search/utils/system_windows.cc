@@ -57,6 +57,23 @@ void register_event_handlers() {
     // SIGXCPU is not supported on Windows.
 }
 
+static volatile sig_atomic_t cancellation_requested = 0;
+
+void cancellation_handler(int signal_number) {
+    cancellation_requested = 1;
+    // A second signal exits at once.
+    signal(signal_number, signal_handler);
+}
+
+void register_cancellation_handlers() {
+    signal(SIGTERM, cancellation_handler);
+    signal(SIGINT, cancellation_handler);
+}
+
+bool is_cancellation_requested() {
+    return cancellation_requested;
+}
+
 void report_exit_code_reentrant(ExitCode exitcode) {
     const char *message = get_exit_code_message_reentrant(exitcode);
     bool is_error = is_exit_code_error_reentrant(exitcode);